@@ -1,5 +1,8 @@
 #include "Controller.hh"
 
+// initializing instancePtr with NULL
+Controller* Controller ::instancePtr = NULL;
+
 Controller::Controller()
 {
     scene = make_shared<Scene>();
@@ -14,9 +17,13 @@ bool Controller::createScene(SceneFactory::SCENE_TYPES currentType, QString name
     case SceneFactory::SCENE_TYPES::VIRTUALWORLD:
         sf = make_shared<SceneFactoryVirtual>();
         break;
-    case SceneFactory::SCENE_TYPES::REALDATA:
-        sf = make_shared<SceneFactoryData>();
+    case SceneFactory::SCENE_TYPES::REALDATA: {
+        auto sfd = make_shared<SceneFactoryData>();
+        // Si ja hi ha càmera, els atributs amb "lod" agreguen les mostres per píxel
+        if (visualSetup != nullptr) sfd->setFootprint(visualSetup->getCamera());
+        sf = sfd;
         break;
+    }
     case SceneFactory::SCENE_TYPES::TEMPORALVW:
         // TO DO:  Afegir les factories de escenes temporals amb les animacions
         return false;
@@ -24,8 +31,11 @@ bool Controller::createScene(SceneFactory::SCENE_TYPES currentType, QString name
     default:
         break;
     }
-    scene = sf->createScene(name);
-    return (scene != nullptr);
+    // Si l'escena no s'ha pogut carregar es manté l'anterior
+    auto s = sf->createScene(name);
+    if (s == nullptr) return false;
+    scene = s;
+    return true;
 }
 
 bool Controller::createScene(vec3 position, float radius) {
@@ -97,6 +107,7 @@ bool Controller::createSettings(QString name) {
 void Controller::rendering(QImage *image) {
     RayTracer *tracer = new RayTracer(image);
     tracer->run();
+    renderStats = tracer->getStats();
     delete tracer;
 }
 
@@ -9,6 +9,7 @@
 
 #include "Model/Rendering/SetUp.hh"
 #include "Model/Rendering/RayTracer.hh"
+#include "Model/Rendering/RenderStats.hh"
 #include "Model/Modelling/Objects/Sphere.hh"
 #include "Model/Modelling/Objects/Box.hh"
 #include "Model/Modelling/Objects/Triangle.hh"
@@ -21,6 +22,8 @@ class Controller
 private:
     shared_ptr<Scene>  scene;
     shared_ptr<SetUp>  visualSetup;
+    // Temps i rajos de l'últim rendering
+    RenderStats        renderStats;
 
     static Controller* // Singleton
 
@@ -58,6 +61,7 @@ public:
 
     shared_ptr<Scene>  getScene() {return scene; }
     shared_ptr<SetUp>  getSetUp() {return visualSetup; }
+    const RenderStats &getRenderStats() const {return renderStats; }
 
     void setScene (shared_ptr<Scene> s) {  scene = s;}
     void setSetUp (shared_ptr<SetUp> v) {  visualSetup = v;}
@@ -2,6 +2,8 @@
 
 AttributeMapping::AttributeMapping()
 {
+    lod = NONE;
+    lodBinSize = 0.0f;
 }
 
 //! [0]
@@ -33,6 +35,12 @@ void AttributeMapping::read(const QJsonObject &json)
         QString objStr = json["colorMap"].toString().toUpper();
         colorMapType = ColorMapStatic::getColorMapType(objStr);
     }
+    if (json.contains("lod") && json["lod"].isString()) {
+        lod = getLodType(json["lod"].toString().toUpper());
+    }
+    if (json.contains("lodBinSize") && json["lodBinSize"].isDouble()) {
+        lodBinSize = json["lodBinSize"].toDouble();
+    }
 
 }
 //! [0]
@@ -54,6 +62,10 @@ void AttributeMapping::write(QJsonObject &json) const
     materialObject["type"] = className2;
     json["material"] = materialObject;
     json["colorMap"] = ColorMapStatic::getNameType(colorMapType);
+    if (lod != NONE) {
+        json["lod"] = getNameLod(lod);
+        if (lodBinSize > 0.0f) json["lodBinSize"] = lodBinSize;
+    }
 }
 
 void AttributeMapping::print(int indentation) const
@@ -70,5 +82,30 @@ void AttributeMapping::print(int indentation) const
     QTextStream(stdout) << indent << "type:\t" << className<<"\n";
     material->print(indentation+2);
     QTextStream(stdout) << indent <<"colorMap:\t"<<ColorMapStatic::getNameType(colorMapType)<<"\n";
+    QTextStream(stdout) << indent <<"lod:\t"<<getNameLod(lod)<<"\n";
+    if (lod != NONE && lodBinSize > 0.0f)
+        QTextStream(stdout) << indent <<"lodBinSize:\t"<<lodBinSize<<"\n";
  }
 
+AttributeMapping::LOD_TYPES AttributeMapping::getLodType(QString name) {
+    if (name == "NONE") return NONE;
+    else if (name == "SUM") return SUM;
+    else if (name == "MEAN") return MEAN;
+    else if (name == "MAX") return MAX;
+    qWarning("Parse error in json data scene file: check the lod aggregation.");
+    return NONE;
+}
+
+QString AttributeMapping::getNameLod(LOD_TYPES t) {
+    switch (t) {
+    case SUM:
+        return QString("SUM");
+    case MEAN:
+        return QString("MEAN");
+    case MAX:
+        return QString("MAX");
+    default:
+        return QString("NONE");
+    }
+}
+
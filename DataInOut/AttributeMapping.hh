@@ -10,6 +10,19 @@
 class AttributeMapping : public Serializable
 {
 public:
+    // Agregació de les mostres quan n'hi ha més d'una per cel·la de la graella de
+    // nivell de detall ("lod"). NONE: cada mostra té el seu gizmo.
+    // MEAN i MAX donen valors dins del rang de les mostres i el color es calcula amb
+    // minValue i maxValue. Les sumes de SUM en surten (creixen amb el nombre de
+    // mostres de la cel·la): el color es calcula amb el mínim i el màxim de les sumes
+    typedef enum
+    {
+        NONE,
+        SUM,
+        MEAN,
+        MAX
+    } LOD_TYPES;
+
     AttributeMapping();
     virtual ~AttributeMapping() {};
     virtual void read (const QJsonObject &json) override;
@@ -25,4 +38,12 @@ public:
     shared_ptr<Material> material;
     ColorMapStatic::COLOR_MAP_TYPES colorMapType;
 
+    LOD_TYPES lod;
+    // Costat de la cel·la de la graella en unitats del món real ("lodBinSize").
+    // Si és 0 es calcula a partir de la mida d'un píxel de la càmera
+    float lodBinSize;
+
+    static LOD_TYPES getLodType(QString name);
+    static QString   getNameLod(LOD_TYPES t);
+
 };
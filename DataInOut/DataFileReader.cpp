@@ -0,0 +1,122 @@
+#include "DataFileReader.hh"
+#include "NumberParsing.hh"
+
+#include <cstring>
+#include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+static_assert(sizeof(vec3) == 3 * sizeof(float), "FLOAT32 data files are copied directly into vec3");
+
+namespace {
+
+inline bool isSeparator(char c) { return c == ',' || c == ';' || isBlank(c); }
+
+inline const char *skipSeparators(const char *p, const char *end) {
+    while (p < end && isSeparator(*p)) p++;
+    return p;
+}
+
+}
+
+bool DataFileReader::load(const QString &fileName, FORMATS format, vector<vec3> &values) {
+    badLines = 0;
+
+    QFile file(fileName);
+    if (!file.exists()) {
+        qWarning("Data file not found.");
+        return false;
+    }
+    if (!file.open(QFile::ReadOnly)) {
+        qWarning("Data file can not be opened.");
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Si el fitxer no es pot mapejar (per exemple un recurs comprimit) es llegeix sencer
+    qint64 size = file.size();
+    const char *data = (const char *)file.map(0, size);
+    QByteArray contents;
+    if (data == nullptr) {
+        contents = file.readAll();
+        data = contents.constData();
+        size = contents.size();
+    }
+
+    size_t before = values.size();
+    bool ok = true;
+    if (format == FLOAT32) {
+        if (size % sizeof(vec3) != 0) {
+            qWarning("Float32 data file size is not a multiple of 3 floats.");
+            ok = false;
+        } else {
+            size_t count = size / sizeof(vec3);
+            values.resize(before + count);
+            if (count > 0) memcpy((void *)&values[before], data, size);
+        }
+    } else {
+        ok = parseCSV(data, data + size, values);
+    }
+    file.close();
+
+    double seconds = timer.nsecsElapsed() * 1e-9;
+    double megabytes = size / (1024.0 * 1024.0);
+    QTextStream(stdout) << "Data " << fileName << ": " << (unsigned long long)(values.size() - before)
+                        << " samples, " << megabytes << " MB in " << seconds << " s ("
+                        << (seconds > 0.0 ? megabytes / seconds : 0.0) << " MB/s)\n";
+    if (badLines > 0)
+        qWarning("%d lines of the data file could not be parsed.", badLines);
+    return ok;
+}
+
+bool DataFileReader::parseCSV(const char *begin, const char *end, vector<vec3> &values) {
+    // Estimació per sota del nombre de mostres (línies d'uns 32 bytes o més)
+    values.reserve(values.size() + (end - begin) / 32);
+
+    bool firstLine = true;
+    const char *p = begin;
+    while (p < end) {
+        const char *line = skipBlanks(p, end);
+        if (line >= end) break;
+        if (*line == '\n' || *line == '#') {
+            p = skipLine(line, end);
+            continue;
+        }
+
+        vec3 sample;
+        const char *q = line;
+        bool ok = true;
+        for (int k = 0; k < 3 && ok; k++) {
+            q = skipSeparators(q, end);
+            ok = parseFloat(q, end, sample[k]);
+        }
+        // Després de la tercera columna no pot quedar res més que separadors
+        q = skipSeparators(q, end);
+        ok = ok && (q >= end || *q == '\n');
+
+        if (ok) values.push_back(sample);
+        else if (!firstLine) badLines++;   // la primera línia pot ser la capçalera
+        firstLine = false;
+        p = skipLine(q, end);
+    }
+    return true;
+}
+
+DataFileReader::FORMATS DataFileReader::getFormat(QString name) {
+    if (name == "CSV") return CSV;
+    else if (name == "FLOAT32") return FLOAT32;
+    qWarning("Parse error in json data scene file: check the data file format.");
+    return CSV;
+}
+
+QString DataFileReader::getNameFormat(FORMATS format) {
+    switch (format) {
+    case FLOAT32:
+        return QString("FLOAT32");
+    default:
+        return QString("CSV");
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <QString>
+#include "glm/glm.hpp"
+
+using namespace std;
+using namespace glm;
+
+// Lector dels fitxers de dades externs d'una escena de dades ("dataFile"), per no
+// haver de posar milions de mostres dins del JSON. Cada mostra són tres columnes:
+// x, z (coordenades al món real) i el valor de l'atribut, en el mateix ordre que
+// les entrades de "data".
+//   CSV:     una mostra per línia, separada per comes, punts i coma o espais.
+//            Les línies buides, les que comencen per # i una capçalera no
+//            numèrica s'ignoren
+//   FLOAT32: floats de 32 bits little-endian seguits, x z valor per mostra
+// El fitxer es mapeja a memòria i es recorre un sol cop: el cost de la lectura
+// depèn del disc i no de la construcció de cap document.
+class DataFileReader
+{
+public:
+    typedef enum
+    {
+        CSV,
+        FLOAT32
+    } FORMATS;
+
+    DataFileReader() {};
+
+    // Afegeix a values les mostres del fitxer. Retorna fals si no s'ha pogut
+    // llegir
+    bool load(const QString &fileName, FORMATS format, vector<vec3> &values);
+
+    // Parseja un CSV que ja és a memòria
+    bool parseCSV(const char *begin, const char *end, vector<vec3> &values);
+
+    static FORMATS getFormat(QString name);
+    static QString getNameFormat(FORMATS format);
+
+    // Línies del CSV que no s'han pogut interpretar
+    int badLines = 0;
+};
@@ -0,0 +1,201 @@
+#include "MeshCache.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+namespace {
+
+// Ordre dels vectors dins del fitxer, just després de la capçalera
+enum CacheArray {
+    VERTEXS, INDEXS, NORMALS, NORMAL_INDEXS, TEX_COORDS, TEX_INDEXS, BVH_NODES, BVH_PRIMS,
+    NUM_ARRAYS
+};
+
+struct CacheHeader
+{
+    char    magic[8];
+    quint32 version;
+    quint32 nodeSize;        // sizeof(BVHNode): detecta canvis en l'estructura del BVH
+    qint64  sourceSize;      // mida del .obj quan es va escriure la cache
+    qint64  sourceModified;  // data de modificació del .obj (ms des de l'epoch)
+    quint64 counts[NUM_ARRAYS];
+};
+
+const char MAGIC[8] = {'R', 'T', 'M', 'E', 'S', 'H', '\0', '\0'};
+
+template <typename T>
+bool writeArray(QFile &file, const vector<T> &v) {
+    qint64 bytes = (qint64)(v.size() * sizeof(T));
+    return bytes == 0 || file.write((const char *)v.data(), bytes) == bytes;
+}
+
+template <typename T>
+bool readArray(const uchar *&p, const uchar *end, quint64 count, vector<T> &v) {
+    // Els vectors de glm 0.9 declaren el constructor de còpia i per això no són
+    // trivially copyable, però no contenen res més que les components
+    static_assert(std::is_standard_layout<T>::value, "cache arrays are copied byte by byte");
+    // count ve del fitxer: es compara sense multiplicar perquè no pugui donar la volta
+    if (count > (quint64)(end - p) / sizeof(T)) return false;
+    quint64 bytes = count * sizeof(T);
+    v.resize(count);
+    if (bytes > 0) memcpy((void *)v.data(), p, bytes);
+    p += bytes;
+    return true;
+}
+
+}
+
+MeshCache::MeshCache(const QString &objFileName)
+{
+    this->objFileName = objFileName;
+    cacheFileName = objFileName + ".meshcache";
+    // Els fitxers dels recursos de Qt (":/...") no es poden escriure
+    enabled = !objFileName.startsWith(":");
+}
+
+bool MeshCache::read(Mesh &mesh) const {
+    if (!enabled) return false;
+
+    QFileInfo source(objFileName);
+    QFile file(cacheFileName);
+    if (!source.exists() || !file.exists()) return false;
+    if (!file.open(QFile::ReadOnly)) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 size = file.size();
+    const uchar *data = file.map(0, size);
+    if (data == nullptr || size < (qint64)sizeof(CacheHeader)) {
+        file.close();
+        return false;
+    }
+
+    CacheHeader header;
+    memcpy(&header, data, sizeof(CacheHeader));
+    bool ok = memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+              header.version == VERSION &&
+              header.nodeSize == sizeof(BVHNode) &&
+              header.sourceSize == source.size() &&
+              header.sourceModified == source.lastModified().toMSecsSinceEpoch();
+
+    const uchar *p = data + sizeof(CacheHeader);
+    const uchar *end = data + size;
+    ok = ok &&
+         readArray(p, end, header.counts[VERTEXS], mesh.vertexs) &&
+         readArray(p, end, header.counts[INDEXS], mesh.indexs) &&
+         readArray(p, end, header.counts[NORMALS], mesh.normals) &&
+         readArray(p, end, header.counts[NORMAL_INDEXS], mesh.normalIndexs) &&
+         readArray(p, end, header.counts[TEX_COORDS], mesh.texCoords) &&
+         readArray(p, end, header.counts[TEX_INDEXS], mesh.texIndexs) &&
+         readArray(p, end, header.counts[BVH_NODES], mesh.bvh.nodes) &&
+         readArray(p, end, header.counts[BVH_PRIMS], mesh.bvh.primIndices) &&
+         isConsistent(mesh);
+
+    file.unmap((uchar *)data);
+    file.close();
+
+    if (ok)
+        QTextStream(stdout) << "OBJ " << objFileName << ": " << mesh.vertexs.size() << " vertexs, "
+                            << mesh.indexs.size() / 3 << " triangles from cache in "
+                            << timer.nsecsElapsed() * 1e-9 << " s\n";
+    return ok;
+}
+
+bool MeshCache::isConsistent(const Mesh &mesh) {
+    if (mesh.indexs.size() % 3 != 0) return false;
+    for (unsigned int i = 0; i < mesh.indexs.size(); i++)
+        if (mesh.indexs[i] >= mesh.vertexs.size()) return false;
+
+    // Normals i coordenades de textura: o no n'hi ha o n'hi ha una per vertex de
+    // cada triangle, amb -1 si aquell vertex no en té
+    if (!mesh.normalIndexs.empty()) {
+        if (mesh.normalIndexs.size() != mesh.indexs.size()) return false;
+        for (unsigned int i = 0; i < mesh.normalIndexs.size(); i++)
+            if (mesh.normalIndexs[i] < -1 || mesh.normalIndexs[i] >= (int)mesh.normals.size()) return false;
+    }
+    if (!mesh.texIndexs.empty()) {
+        if (mesh.texIndexs.size() != mesh.indexs.size()) return false;
+        for (unsigned int i = 0; i < mesh.texIndexs.size(); i++)
+            if (mesh.texIndexs[i] < -1 || mesh.texIndexs[i] >= (int)mesh.texCoords.size()) return false;
+    }
+
+    int nTriangles = (int)(mesh.indexs.size() / 3);
+    const vector<int> &prims = mesh.bvh.primIndices;
+    for (unsigned int i = 0; i < prims.size(); i++)
+        if (prims[i] < 0 || prims[i] >= nTriangles) return false;
+
+    // El BVH es construeix amb els fills després del pare: exigir-ho garanteix que
+    // el recorregut acaba, i la profunditat no pot passar de la de les piles
+    const vector<BVHNode> &nodes = mesh.bvh.nodes;
+    vector<int> depth(nodes.size(), 0);
+    for (int i = 0; i < (int)nodes.size(); i++) {
+        const BVHNode &node = nodes[i];
+        if (node.count > 0) {
+            if (node.leftFirst < 0 || node.leftFirst > (int)prims.size() - node.count) return false;
+        } else if (node.count == 0) {
+            if (node.leftFirst <= i || node.leftFirst >= (int)nodes.size() - 1) return false;
+            if (depth[i] + 1 > BVH::MAX_DEPTH) return false;
+            depth[node.leftFirst] = std::max(depth[node.leftFirst], depth[i] + 1);
+            depth[node.leftFirst + 1] = std::max(depth[node.leftFirst + 1], depth[i] + 1);
+        } else
+            return false;
+    }
+    return true;
+}
+
+bool MeshCache::write(const Mesh &mesh) const {
+    if (!enabled) return false;
+
+    QFileInfo source(objFileName);
+    if (!source.exists()) return false;
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(CacheHeader));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.nodeSize = sizeof(BVHNode);
+    header.sourceSize = source.size();
+    header.sourceModified = source.lastModified().toMSecsSinceEpoch();
+    header.counts[VERTEXS] = mesh.vertexs.size();
+    header.counts[INDEXS] = mesh.indexs.size();
+    header.counts[NORMALS] = mesh.normals.size();
+    header.counts[NORMAL_INDEXS] = mesh.normalIndexs.size();
+    header.counts[TEX_COORDS] = mesh.texCoords.size();
+    header.counts[TEX_INDEXS] = mesh.texIndexs.size();
+    header.counts[BVH_NODES] = mesh.bvh.nodes.size();
+    header.counts[BVH_PRIMS] = mesh.bvh.primIndices.size();
+
+    // S'escriu a un fitxer temporal i es reanomena al final, perquè una escriptura
+    // a mitges no deixi una cache aparentment vàlida
+    QString tmpFileName = cacheFileName + ".tmp";
+    QFile file(tmpFileName);
+    if (!file.open(QFile::WriteOnly)) return false;
+
+    bool ok = file.write((const char *)&header, sizeof(CacheHeader)) == (qint64)sizeof(CacheHeader) &&
+              writeArray(file, mesh.vertexs) &&
+              writeArray(file, mesh.indexs) &&
+              writeArray(file, mesh.normals) &&
+              writeArray(file, mesh.normalIndexs) &&
+              writeArray(file, mesh.texCoords) &&
+              writeArray(file, mesh.texIndexs) &&
+              writeArray(file, mesh.bvh.nodes) &&
+              writeArray(file, mesh.bvh.primIndices);
+    file.close();
+
+    if (ok) {
+        QFile::remove(cacheFileName);
+        ok = QFile::rename(tmpFileName, cacheFileName);
+    }
+    if (!ok) {
+        QFile::remove(tmpFileName);
+        qWarning("Mesh cache file can not be written.");
+    }
+    return ok;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QString>
+#include "Model/Modelling/Objects/Mesh.hh"
+
+// Cache binària d'una malla carregada d'un .obj. Es guarda al costat del fitxer
+// original (nom.obj.meshcache) amb els vertexs, els índexs, les normals, les
+// coordenades de textura i el BVH ja construit, de manera que en tornar a obrir
+// l'escena no cal parsejar el text ni construir el BVH. La cache queda invalidada
+// si la mida o la data de modificació del .obj no coincideixen amb les guardades.
+class MeshCache
+{
+public:
+    MeshCache(const QString &objFileName);
+
+    // Omple la malla amb el contingut de la cache. Retorna fals si no n'hi ha,
+    // si està desfasada o si el contingut no és coherent (índexs fora de rang)
+    bool read(Mesh &mesh) const;
+
+    // Escriu la cache de la malla ja carregada
+    bool write(const Mesh &mesh) const;
+
+    bool isEnabled() const { return enabled; }
+
+private:
+    static const quint32 VERSION = 1;
+
+    // Comprova que tots els índexs de la malla i del BVH llegits siguin dins de
+    // rang, perquè un fitxer truncat o corrupte no faci llegir fora dels vectors
+    static bool isConsistent(const Mesh &mesh);
+
+    QString objFileName;
+    QString cacheFileName;
+    bool    enabled;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cmath>
+#include <climits>
+#include <cstdint>
+
+// Conversió de text a nombres directament des dels bytes d'un fitxer mapejat a
+// memòria, sense crear cap objecte ni copiar el text. La fan servir els lectors de
+// fitxers de text grans (ObjReader, DataFileReader). Cada funció avança p fins al
+// primer caràcter que no ha consumit i no passa mai d'end.
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline const char *skipBlanks(const char *p, const char *end) {
+    while (p < end && isBlank(*p)) p++;
+    return p;
+}
+
+inline const char *skipLine(const char *p, const char *end) {
+    while (p < end && *p != '\n') p++;
+    return p < end ? p + 1 : end;
+}
+
+// Potències de 10 representables exactament en double
+const double POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool parseInt(const char *&p, const char *end, int &value) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    if (p >= end || !isDigit(*p)) return false;
+    // S'acumula en 64 bits i es deixa de sumar quan ja no cap en un int (INT_MIN
+    // té un valor absolut més gran que INT_MAX); els dígits que queden es consumeixen
+    int64_t limit = negative ? -(int64_t)INT_MIN : (int64_t)INT_MAX;
+    int64_t v = 0;
+    bool overflow = false;
+    while (p < end && isDigit(*p)) {
+        if (!overflow) {
+            v = v*10 + (*p - '0');
+            overflow = v > limit;
+        }
+        p++;
+    }
+    if (overflow) return false;
+    value = (int)(negative ? -v : v);
+    return true;
+}
+
+// Es guarden fins a 19 digits significatius a la mantissa i la resta només
+// compten per a l'exponent. Amb exponents petits el resultat és el mateix que
+// el de strtod un cop arrodonit a float.
+inline bool parseFloat(const char *&p, const char *end, float &value) {
+    p = skipBlanks(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    while (p < end && isDigit(*p)) {
+        if (digits < 19) {
+            mantissa = mantissa*10 + (*p - '0');
+            if (mantissa > 0) digits++;
+        } else exponent++;
+        any = true;
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && isDigit(*p)) {
+            if (digits < 19) {
+                mantissa = mantissa*10 + (*p - '0');
+                if (mantissa > 0) digits++;
+                exponent--;
+            }
+            any = true;
+            p++;
+        }
+    }
+    if (!any) return false;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        int e;
+        if (parseInt(q, end, e)) {
+            exponent += e;
+            p = q;
+        }
+    }
+
+    double v = (double)mantissa;
+    if (exponent > 0)
+        v = exponent <= 22 ? v * POW10[exponent] : v * std::pow(10.0, exponent);
+    else if (exponent < 0)
+        v = exponent >= -22 ? v / POW10[-exponent] : v * std::pow(10.0, exponent);
+    value = (float)(negative ? -v : v);
+    return true;
+}
@@ -0,0 +1,162 @@
+#include "ObjReader.hh"
+#include "NumberParsing.hh"
+
+#include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+namespace {
+
+// Passa un índex de l'obj (1..n o negatiu des del final) a un índex 0..n-1
+inline bool resolveIndex(int idx, size_t count, int &out) {
+    if (idx > 0) out = idx - 1;
+    else if (idx < 0) out = (int)count + idx;
+    else return false;
+    return out >= 0 && (size_t)out < count;
+}
+
+// Vèrtex d'una cara: v, v/vt, v//vn o v/vt/vn
+struct Corner
+{
+    int v, t, n;
+};
+
+}
+
+bool ObjReader::load(const QString &fileName) {
+    clear();
+
+    QFile file(fileName);
+    if (!file.exists()) {
+        qWarning("Boundary object file not found.");
+        return false;
+    }
+    if (!file.open(QFile::ReadOnly)) {
+        qWarning("Boundary object file can not be opened.");
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Si el fitxer no es pot mapejar (per exemple un recurs comprimit) es llegeix sencer
+    qint64 size = file.size();
+    const char *data = (const char *)file.map(0, size);
+    QByteArray contents;
+    if (data == nullptr) {
+        contents = file.readAll();
+        data = contents.constData();
+        size = contents.size();
+    }
+
+    bool ok = parse(data, data + size);
+    file.close();
+
+    double seconds = timer.nsecsElapsed() * 1e-9;
+    double megabytes = size / (1024.0 * 1024.0);
+    QTextStream(stdout) << "OBJ " << fileName << ": " << positions.size() << " vertexs, "
+                        << indexs.size() / 3 << " triangles, " << megabytes << " MB in "
+                        << seconds << " s (" << (seconds > 0.0 ? megabytes / seconds : 0.0)
+                        << " MB/s)\n";
+    if (badLines > 0)
+        qWarning("%d lines of the object file could not be parsed.", badLines);
+    return ok;
+}
+
+bool ObjReader::parse(const char *begin, const char *end) {
+    const char *p = begin;
+    while (p < end) {
+        p = skipBlanks(p, end);
+        if (p >= end) break;
+
+        bool ok = true;
+        if (p[0] == 'v' && p + 1 < end && isBlank(p[1])) {
+            p += 2;
+            vec3 v;
+            ok = parseFloat(p, end, v.x) && parseFloat(p, end, v.y) && parseFloat(p, end, v.z);
+            if (ok) positions.push_back(v);
+        }
+        else if (p[0] == 'v' && p + 2 < end && p[1] == 'n' && isBlank(p[2])) {
+            p += 3;
+            vec3 n;
+            ok = parseFloat(p, end, n.x) && parseFloat(p, end, n.y) && parseFloat(p, end, n.z);
+            if (ok) normals.push_back(n);
+        }
+        else if (p[0] == 'v' && p + 2 < end && p[1] == 't' && isBlank(p[2])) {
+            // La v és opcional; la tercera coordenada s'ignora
+            p += 3;
+            vec2 t(0.0f);
+            ok = parseFloat(p, end, t.x);
+            if (ok) {
+                parseFloat(p, end, t.y);
+                texCoords.push_back(t);
+            }
+        }
+        else if (p[0] == 'f' && p + 1 < end && isBlank(p[1])) {
+            p += 2;
+            Corner first, prev, cur;
+            int nCorners = 0;
+            while (true) {
+                p = skipBlanks(p, end);
+                if (p >= end || *p == '\n' || *p == '#') break;
+
+                int idx;
+                cur.t = -1;
+                cur.n = -1;
+                if (!parseInt(p, end, idx) || !resolveIndex(idx, positions.size(), cur.v)) {
+                    ok = false;
+                    break;
+                }
+                if (p < end && *p == '/') {
+                    p++;
+                    if (p < end && *p != '/') {
+                        if (!parseInt(p, end, idx) || !resolveIndex(idx, texCoords.size(), cur.t)) {
+                            ok = false;
+                            break;
+                        }
+                    }
+                    if (p < end && *p == '/') {
+                        p++;
+                        if (!parseInt(p, end, idx) || !resolveIndex(idx, normals.size(), cur.n)) {
+                            ok = false;
+                            break;
+                        }
+                    }
+                }
+
+                // Triangulació en ventall des del primer vèrtex
+                if (nCorners == 0) first = cur;
+                else if (nCorners >= 2) {
+                    const Corner *tri[3] = {&first, &prev, &cur};
+                    for (int k = 0; k < 3; k++) {
+                        indexs.push_back(tri[k]->v);
+                        normalIndexs.push_back(tri[k]->n);
+                        texIndexs.push_back(tri[k]->t);
+                    }
+                }
+                prev = cur;
+                nCorners++;
+            }
+            if (nCorners < 3) ok = false;
+        }
+
+        if (!ok) badLines++;
+        p = skipLine(p, end);
+    }
+
+    // Si el fitxer no té normals o coordenades de textura no cal guardar-ne els índexs
+    if (normals.empty()) vector<int>().swap(normalIndexs);
+    if (texCoords.empty()) vector<int>().swap(texIndexs);
+    return true;
+}
+
+void ObjReader::clear() {
+    positions.clear();
+    normals.clear();
+    texCoords.clear();
+    indexs.clear();
+    normalIndexs.clear();
+    texIndexs.clear();
+    badLines = 0;
+}
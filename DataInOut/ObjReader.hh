@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <QString>
+#include "glm/glm.hpp"
+
+using namespace std;
+using namespace glm;
+
+// Lector de fitxers .obj. El fitxer es mapeja a memòria i es recorre un sol cop
+// sense crear cap objecte per línia: els nombres es converteixen directament
+// des dels bytes del fitxer. Entén v, vn, vt i f (triangles, quads i n-gons, que
+// es triangulen en ventall) i els índexs negatius (relatius al final).
+// La resta de línies (comentaris, g, o, s, usemtl...) s'ignoren.
+class ObjReader
+{
+public:
+    ObjReader() {};
+
+    // Llegeix el fitxer i omple els vectors. Retorna fals si no s'ha pogut obrir
+    bool load(const QString &fileName);
+
+    // Parseja el contingut d'un .obj que ja és a memòria
+    bool parse(const char *begin, const char *end);
+
+    void clear();
+
+    vector<vec3> positions;
+    vector<vec3> normals;
+    vector<vec2> texCoords;
+
+    // 3 entrades per triangle. normalIndexs i texIndexs valen -1 als vèrtexs que no
+    // en tenen, i queden buits si el fitxer no té cap vn (o vt)
+    vector<unsigned int> indexs;
+    vector<int>          normalIndexs;
+    vector<int>          texIndexs;
+
+    // Línies que no s'han pogut interpretar
+    int badLines = 0;
+};
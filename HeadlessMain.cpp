@@ -0,0 +1,58 @@
+#include <QCoreApplication>
+#include <QFile>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+#include "Controller.hh"
+
+// Render sense interfície gràfica:
+//    p1-graphics-cli escena.json setup.json imatge.png
+// El tipus d'escena (VIRTUALWORLD o REALDATA) es llegeix del camp "typeScene"
+// del fitxer d'escena, igual que es fa des dels menús de la finestra.
+
+static SceneFactory::SCENE_TYPES sceneTypeOf(QString fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return SceneFactory::SCENE_TYPES::VIRTUALWORLD;
+    QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+    if (json.contains("typeScene") && json["typeScene"].isString())
+        return SceneFactory::getSceneFactoryType(json["typeScene"].toString().toUpper());
+    return SceneFactory::SCENE_TYPES::VIRTUALWORLD;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QStringList args = a.arguments();
+    if (args.count() != 4) {
+        QTextStream(stderr) << "Usage: " << args.at(0) << " scene.json setup.json output.png\n";
+        return 1;
+    }
+    QString sceneFile = args.at(1);
+    QString setupFile = args.at(2);
+    QString outputFile = args.at(3);
+
+    Controller *controller = Controller::getInstance();
+    if (!controller->createScene(sceneTypeOf(sceneFile), sceneFile)) {
+        qWarning("Scene NOT loaded. Error reading data.");
+        return 1;
+    }
+    if (!controller->createSettings(setupFile)) {
+        qWarning("Settings NOT loaded. Error reading data.");
+        return 1;
+    }
+
+    auto camera = controller->getSetUp()->getCamera();
+    QImage image(camera->viewportX, camera->viewportY, QImage::Format_RGB888);
+
+    controller->rendering(&image);
+    controller->getRenderStats().print();
+
+    if (!image.save(outputFile)) {
+        qWarning("The image can not be saved.");
+        return 1;
+    }
+    return 0;
+}
@@ -3,9 +3,6 @@
 #include "Controller.hh"
 #include "View/MainWindow.hh"
 
-// initializing instancePtr with NULL
-Controller* Controller ::instancePtr = NULL;
-
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
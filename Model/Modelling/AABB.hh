@@ -0,0 +1,67 @@
+#pragma once
+
+#include <limits>
+#include "glm/glm.hpp"
+#include "Ray.hh"
+
+using namespace glm;
+
+// Capsa contenidora alineada amb els eixos (Axis Aligned Bounding Box)
+class AABB {
+  public:
+    vec3 pmin;
+    vec3 pmax;
+
+    // Capsa buida: qualsevol expand() la inicialitza
+    AABB():
+      pmin(std::numeric_limits<float>::infinity()),
+      pmax(-std::numeric_limits<float>::infinity())
+    {}
+
+    AABB(const vec3 &p1, const vec3 &p2):
+      pmin(glm::min(p1, p2)),
+      pmax(glm::max(p1, p2))
+    {}
+
+    bool isEmpty() const { return pmin.x > pmax.x || pmin.y > pmax.y || pmin.z > pmax.z; }
+
+    void expand(const vec3 &p) {
+      pmin = glm::min(pmin, p);
+      pmax = glm::max(pmax, p);
+    }
+
+    void expand(const AABB &b) {
+      pmin = glm::min(pmin, b.pmin);
+      pmax = glm::max(pmax, b.pmax);
+    }
+
+    vec3 centroid() const { return 0.5f*(pmin + pmax); }
+
+    vec3 extent() const { return pmax - pmin; }
+
+    // Eix (0, 1 o 2) on la capsa és més llarga
+    int maxAxis() const {
+      vec3 e = extent();
+      if (e.x > e.y && e.x > e.z) return 0;
+      return (e.y > e.z) ? 1 : 2;
+    }
+
+    float surfaceArea() const {
+      if (isEmpty()) return 0.0f;
+      vec3 e = extent();
+      return 2.0f*(e.x*e.y + e.y*e.z + e.z*e.x);
+    }
+
+    // Test de les slabs (Kay i Kajiya) amb la inversa de la direccio del raig
+    // precalculada. Retorna la t d'entrada a la capsa o infinit si no hi ha interseccio
+    // dins de [tmin, tmax]
+    float hit(const vec3 &origin, const vec3 &invDir, float tmin, float tmax) const {
+      vec3 t0 = (pmin - origin) * invDir;
+      vec3 t1 = (pmax - origin) * invDir;
+      vec3 tnear = glm::min(t0, t1);
+      vec3 tfar = glm::max(t0, t1);
+      float tenter = glm::max(glm::max(tnear.x, tnear.y), glm::max(tnear.z, tmin));
+      float texit = glm::min(glm::min(tfar.x, tfar.y), glm::min(tfar.z, tmax));
+      return (tenter <= texit) ? tenter : std::numeric_limits<float>::infinity();
+    }
+};
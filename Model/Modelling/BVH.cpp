@@ -0,0 +1,148 @@
+#include "BVH.hh"
+
+#include <algorithm>
+
+void BVH::clear() {
+    nodes.clear();
+    primIndices.clear();
+}
+
+void BVH::build(const vector<AABB> &primBounds, int maxLeafSize, int leafGroup) {
+    clear();
+    this->leafGroup = std::max(leafGroup, 1);
+    int n = (int)primBounds.size();
+    if (n == 0) return;
+
+    vector<vec3> centroids(n);
+    primIndices.resize(n);
+    for (int i = 0; i < n; i++) {
+        primIndices[i] = i;
+        centroids[i] = primBounds[i].centroid();
+    }
+
+    nodes.reserve(2*n);
+    BVHNode root;
+    root.leftFirst = 0;
+    root.count = n;
+    nodes.push_back(root);
+    subdivide(0, primBounds, centroids, maxLeafSize, 1);
+}
+
+void BVH::subdivide(int nodeIdx, const vector<AABB> &primBounds, const vector<vec3> &centroids,
+                    int maxLeafSize, int depth) {
+    BVHNode &node = nodes[nodeIdx];
+    int first = node.leftFirst;
+    int count = node.count;
+
+    AABB bounds;
+    for (int i = first; i < first + count; i++)
+        bounds.expand(primBounds[primIndices[i]]);
+    node.bounds = bounds;
+
+    if (count <= 1 || depth >= MAX_DEPTH) return;
+
+    int axis;
+    float splitPos, splitCost;
+    bool found = findSplit(node, primBounds, centroids, axis, splitPos, splitCost);
+
+    // Cost de no dividir: intersecar totes les primitives de la fulla
+    if (!found || (splitCost >= leafCost(count) && count <= maxLeafSize)) return;
+
+    int *begin = primIndices.data() + first;
+    int *mid = std::partition(begin, begin + count, [&](int p) {
+        return centroids[p][axis] < splitPos;
+    });
+    int leftCount = (int)(mid - begin);
+
+    // Tots els centroides al mateix costat: es parteix per la meitat
+    if (leftCount == 0 || leftCount == count) {
+        if (count <= maxLeafSize) return;
+        leftCount = count / 2;
+        std::nth_element(begin, begin + leftCount, begin + count, [&](int a, int b) {
+            return centroids[a][axis] < centroids[b][axis];
+        });
+    }
+
+    int leftIdx = (int)nodes.size();
+    BVHNode left, right;
+    left.leftFirst = first;
+    left.count = leftCount;
+    right.leftFirst = first + leftCount;
+    right.count = count - leftCount;
+    nodes.push_back(left);
+    nodes.push_back(right);
+
+    // push_back pot haver invalidat la referencia a node
+    nodes[nodeIdx].leftFirst = leftIdx;
+    nodes[nodeIdx].count = 0;
+
+    subdivide(leftIdx, primBounds, centroids, maxLeafSize, depth + 1);
+    subdivide(leftIdx + 1, primBounds, centroids, maxLeafSize, depth + 1);
+}
+
+bool BVH::findSplit(const BVHNode &node, const vector<AABB> &primBounds, const vector<vec3> &centroids,
+                    int &axis, float &splitPos, float &cost) const {
+    int first = node.leftFirst;
+    int count = node.count;
+
+    AABB centroidBounds;
+    for (int i = first; i < first + count; i++)
+        centroidBounds.expand(centroids[primIndices[i]]);
+
+    // Amb capses degenerades (àrea 0) qualsevol partició té el mateix cost
+    float parentArea = std::max(node.bounds.surfaceArea(), std::numeric_limits<float>::min());
+    bool found = false;
+    cost = std::numeric_limits<float>::infinity();
+
+    for (int a = 0; a < 3; a++) {
+        float cmin = centroidBounds.pmin[a];
+        float cmax = centroidBounds.pmax[a];
+        if (cmax <= cmin) continue;
+
+        // Repartiment de les primitives en bins segons el centroide
+        AABB binBounds[NUM_BINS];
+        int  binCount[NUM_BINS] = {0};
+        float scale = NUM_BINS / (cmax - cmin);
+        for (int i = first; i < first + count; i++) {
+            int p = primIndices[i];
+            int b = std::min(NUM_BINS - 1, (int)((centroids[p][a] - cmin) * scale));
+            binCount[b]++;
+            binBounds[b].expand(primBounds[p]);
+        }
+
+        // Àrees i comptadors acumulats d'esquerra a dreta i de dreta a esquerra
+        float leftArea[NUM_BINS - 1], rightArea[NUM_BINS - 1];
+        int   leftCount[NUM_BINS - 1], rightCount[NUM_BINS - 1];
+        AABB leftBox, rightBox;
+        int leftSum = 0, rightSum = 0;
+        for (int i = 0; i < NUM_BINS - 1; i++) {
+            leftSum += binCount[i];
+            leftCount[i] = leftSum;
+            leftBox.expand(binBounds[i]);
+            leftArea[i] = leftBox.surfaceArea();
+
+            rightSum += binCount[NUM_BINS - 1 - i];
+            rightCount[NUM_BINS - 2 - i] = rightSum;
+            rightBox.expand(binBounds[NUM_BINS - 1 - i]);
+            rightArea[NUM_BINS - 2 - i] = rightBox.surfaceArea();
+        }
+
+        // SAH: cost de travessar el node + cost esperat d'intersecar cada fill
+        for (int i = 0; i < NUM_BINS - 1; i++) {
+            if (leftCount[i] == 0 || rightCount[i] == 0) continue;
+            float c = 0.125f + (leafCost(leftCount[i])*leftArea[i] + leafCost(rightCount[i])*rightArea[i]) / parentArea;
+            if (c < cost) {
+                cost = c;
+                axis = a;
+                splitPos = cmin + (i + 1) / scale;
+                found = true;
+            }
+        }
+    }
+
+    if (!found) {
+        axis = centroidBounds.maxAxis();
+        splitPos = centroidBounds.centroid()[axis];
+    }
+    return found;
+}
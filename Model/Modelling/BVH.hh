@@ -0,0 +1,271 @@
+#pragma once
+
+#include <vector>
+#include "AABB.hh"
+#include "RayPacket.hh"
+
+using namespace std;
+
+// Node del BVH (32 bytes). Si count > 0 és una fulla que conté les primitives
+// primIndices[leftFirst .. leftFirst+count); si no, els fills són els nodes
+// leftFirst i leftFirst+1.
+struct BVHNode
+{
+    AABB bounds;
+    int  leftFirst;
+    int  count;
+
+    bool isLeaf() const { return count > 0; }
+};
+
+// Bounding Volume Hierarchy sobre un conjunt de primitives de les quals només
+// coneix les capses contenidores. La construcció fa servir la heurística SAH
+// (Surface Area Heuristic) amb bins. El recorregut delega la intersecció amb
+// cada primitiva a la funció que rep, de manera que el mateix BVH serveix per
+// als objectes de l'escena i per als triangles d'una malla.
+class BVH
+{
+public:
+    BVH() {};
+
+    // Construeix l'arbre. maxLeafSize: màxim de primitives per fulla. leafGroup:
+    // primitives que es proven alhora a les fulles (SIMD); la SAH compta el cost
+    // d'una fulla per grups i no per primitives
+    void build(const vector<AABB> &primBounds, int maxLeafSize = 4, int leafGroup = 1);
+
+    void clear();
+    bool isEmpty() const { return nodes.empty(); }
+    AABB getBounds() const { return nodes.empty() ? AABB() : nodes[0].bounds; }
+
+    // Recorre l'arbre de més a prop a més lluny. intersect(prim, tmin, tmax) ha de
+    // retornar cert si la primitiva prim té una interseccio dins de [tmin, tmax] i,
+    // en aquest cas, deixar a tmax la t de la nova interseccio.
+    // Retorna cert si alguna primitiva ha estat intersecada.
+    template <typename F>
+    bool traverse(const Ray &r, float tmin, float &tmax, F intersect) const;
+
+    // Com traverse(), però intersectLeaf(first, count, tmin, tmax) rep la fulla
+    // sencera: les primitives primIndices[first .. first+count). Permet provar
+    // totes les primitives d'una fulla alhora
+    template <typename F>
+    bool traverseLeaves(const Ray &r, float tmin, float &tmax, F intersectLeaf) const;
+
+    // Recorregut any-hit per a consultes d'oclusió: acaba tan bon punt
+    // test(prim, tmin, tmax) retorna cert, sense ordenar els fills per distància.
+    // Retorna cert si alguna primitiva ha retornat cert.
+    template <typename F>
+    bool any(const Ray &r, float tmin, float tmax, F test) const;
+
+    // Com any(), però testLeaf(first, count, tmin, tmax) rep la fulla sencera
+    template <typename F>
+    bool anyLeaves(const Ray &r, float tmin, float tmax, F testLeaf) const;
+
+    // Recorregut d'un paquet de rajos coherents. Cada node es prova amb tots els
+    // rajos actius alhora i es baixa pels fills que talla algun raig, primer pel
+    // més proper. A les fulles es crida intersect(prim, lane, tmin, tmax) per a
+    // cada raig del paquet que talla la fulla; tmax és packet.tmax[lane] i s'ha
+    // d'actualitzar com a traverse().
+    template <typename F>
+    void traversePacket(RayPacket &packet, float tmin, F intersect) const;
+
+    // Com traversePacket(), però intersectLeaf(first, count, lane, tmin, tmax) rep
+    // la fulla sencera, com a traverseLeaves()
+    template <typename F>
+    void traversePacketLeaves(RayPacket &packet, float tmin, F intersectLeaf) const;
+
+    vector<BVHNode> nodes;
+    vector<int>     primIndices;
+
+    // Profunditat màxima de l'arbre: dona la mida de les piles del recorregut
+    static const int MAX_DEPTH = 64;
+
+private:
+    static const int NUM_BINS = 16;
+
+    int leafGroup = 1;
+
+    // Cost d'intersecar count primitives d'una fulla
+    float leafCost(int count) const { return (float)((count + leafGroup - 1) / leafGroup); }
+
+    void subdivide(int nodeIdx, const vector<AABB> &primBounds, const vector<vec3> &centroids,
+                   int maxLeafSize, int depth);
+    bool findSplit(const BVHNode &node, const vector<AABB> &primBounds, const vector<vec3> &centroids,
+                   int &axis, float &splitPos, float &cost) const;
+};
+
+
+template <typename F>
+bool BVH::traverse(const Ray &r, float tmin, float &tmax, F intersect) const {
+    return traverseLeaves(r, tmin, tmax, [&](int first, int count, float t0, float &t1) {
+        bool hitLeaf = false;
+        for (int i = first; i < first + count; i++) {
+            if (intersect(primIndices[i], t0, t1))
+                hitLeaf = true;
+        }
+        return hitLeaf;
+    });
+}
+
+template <typename F>
+bool BVH::traverseLeaves(const Ray &r, float tmin, float &tmax, F intersectLeaf) const {
+    if (nodes.empty()) return false;
+
+    vec3 origin = r.getOrigin();
+    const vec3 &invDir = r.getInvDirection();
+    bool hitAnything = false;
+
+    int stack[MAX_DEPTH];
+    int stackSize = 0;
+
+    if (nodes[0].bounds.hit(origin, invDir, tmin, tmax) == std::numeric_limits<float>::infinity())
+        return false;
+    int current = 0;
+
+    while (true) {
+        const BVHNode &node = nodes[current];
+        if (node.isLeaf()) {
+            if (intersectLeaf(node.leftFirst, node.count, tmin, tmax))
+                hitAnything = true;
+        } else {
+            // Es visita primer el fill més proper i s'apila l'altre
+            int first = node.leftFirst;
+            int second = node.leftFirst + 1;
+            float t1 = nodes[first].bounds.hit(origin, invDir, tmin, tmax);
+            float t2 = nodes[second].bounds.hit(origin, invDir, tmin, tmax);
+            if (t2 < t1) {
+                std::swap(t1, t2);
+                std::swap(first, second);
+            }
+            if (t1 != std::numeric_limits<float>::infinity()) {
+                if (t2 != std::numeric_limits<float>::infinity())
+                    stack[stackSize++] = second;
+                current = first;
+                continue;
+            }
+        }
+
+        // Es desapilen els nodes que ja queden més lluny que la interseccio trobada
+        bool found = false;
+        while (stackSize > 0) {
+            current = stack[--stackSize];
+            if (nodes[current].bounds.hit(origin, invDir, tmin, tmax) != std::numeric_limits<float>::infinity()) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) break;
+    }
+    return hitAnything;
+}
+
+
+template <typename F>
+void BVH::traversePacket(RayPacket &packet, float tmin, F intersect) const {
+    traversePacketLeaves(packet, tmin, [&](int first, int count, int lane, float t0, float &t1) {
+        for (int i = first; i < first + count; i++)
+            intersect(primIndices[i], lane, t0, t1);
+    });
+}
+
+template <typename F>
+void BVH::traversePacketLeaves(RayPacket &packet, float tmin, F intersectLeaf) const {
+    if (nodes.empty()) return;
+
+    float tEnter[RayPacket::SIZE], tEnter2[RayPacket::SIZE];
+    int stack[MAX_DEPTH];
+    int stackSize = 0;
+
+    int mask = packet.intersect(nodes[0].bounds, tmin, tEnter);
+    if (mask == 0) return;
+    int current = 0;
+
+    // t d'entrada més petita entre els rajos de la màscara
+    auto nearest = [](int m, const float *t) {
+        float tnear = std::numeric_limits<float>::infinity();
+        for (int i = 0; i < RayPacket::SIZE; i++)
+            if ((m & (1 << i)) && t[i] < tnear) tnear = t[i];
+        return tnear;
+    };
+
+    while (true) {
+        const BVHNode &node = nodes[current];
+        if (node.isLeaf()) {
+            for (int lane = 0; lane < RayPacket::SIZE; lane++) {
+                if (mask & (1 << lane))
+                    intersectLeaf(node.leftFirst, node.count, lane, tmin, packet.tmax[lane]);
+            }
+        } else {
+            int first = node.leftFirst;
+            int second = node.leftFirst + 1;
+            int mask1 = packet.intersect(nodes[first].bounds, tmin, tEnter);
+            int mask2 = packet.intersect(nodes[second].bounds, tmin, tEnter2);
+            if (mask1 != 0 && mask2 != 0) {
+                if (nearest(mask2, tEnter2) < nearest(mask1, tEnter)) {
+                    std::swap(first, second);
+                    std::swap(mask1, mask2);
+                }
+                stack[stackSize++] = second;
+            } else if (mask2 != 0) {
+                first = second;
+                mask1 = mask2;
+            }
+            if (mask1 != 0) {
+                current = first;
+                mask = mask1;
+                continue;
+            }
+        }
+
+        // En desapilar es torna a provar el node: els rajos que ja han trobat una
+        // interseccio més propera queden fora de la màscara
+        bool found = false;
+        while (stackSize > 0) {
+            current = stack[--stackSize];
+            mask = packet.intersect(nodes[current].bounds, tmin, tEnter);
+            if (mask != 0) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) break;
+    }
+}
+
+
+template <typename F>
+bool BVH::any(const Ray &r, float tmin, float tmax, F test) const {
+    return anyLeaves(r, tmin, tmax, [&](int first, int count, float t0, float t1) {
+        for (int i = first; i < first + count; i++) {
+            if (test(primIndices[i], t0, t1))
+                return true;
+        }
+        return false;
+    });
+}
+
+template <typename F>
+bool BVH::anyLeaves(const Ray &r, float tmin, float tmax, F testLeaf) const {
+    if (nodes.empty()) return false;
+
+    vec3 origin = r.getOrigin();
+    const vec3 &invDir = r.getInvDirection();
+
+    // Cada nivell hi deixa com a molt un germà pendent, més el node actual
+    int stack[MAX_DEPTH + 1];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BVHNode &node = nodes[stack[--stackSize]];
+        if (node.bounds.hit(origin, invDir, tmin, tmax) == std::numeric_limits<float>::infinity())
+            continue;
+        if (node.isLeaf()) {
+            if (testLeaf(node.leftFirst, node.count, tmin, tmax))
+                return true;
+        } else {
+            stack[stackSize++] = node.leftFirst + 1;
+            stack[stackSize++] = node.leftFirst;
+        }
+    }
+    return false;
+}
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "Ray.hh"
+#include "Random.hh"
 
 
 using namespace std;
 class Material;
+class Object;
 
 
 class HitInfo
@@ -15,13 +17,16 @@ public:
     vec3      normal;    // normal en el punt d'intersecció
     Material *mat_ptr;   // material de l'objecte que s'ha intersectat
     vec2      uv;        // punt 2D per la projeccio de la textura
+    vec2      bary;      // coordenades baricentriques (u, v) del punt, si és un triangle:
+                         // p = (1-u-v)*v1 + u*v2 + v*v3
 
     HitInfo():
         t(std::numeric_limits<float>::infinity()),
         p(0.0f),
         normal(0.0f),
         mat_ptr(NULL),
-        uv(0.0f)
+        uv(0.0f),
+        bary(0.0f)
         {}
 
     //  "operator =" per la classe  IntersectionInfo
@@ -31,10 +36,32 @@ public:
       normal = rhs.normal;
       t = rhs.t;
       uv = rhs.uv;
+      bary = rhs.bary;
       return *this;
     }
 };
 
+// Resultat compacte de la fase barata de la intersecció: només la t, l'objecte,
+// un identificador de primitiva dins de l'objecte (triangle, esfera, cara...) i les
+// coordenades baricentriques. Mentre es recorre l'escena només es guarda això per a
+// cada candidat; el punt, la normal, les coordenades de textura i el material
+// (HitInfo) es calculen un sol cop per a la intersecció guanyadora amb
+// Object::finalize()
+struct HitRecord
+{
+    float         t;
+    const Object *object;
+    int           primId;
+    vec2          bary;
+
+    HitRecord():
+        t(std::numeric_limits<float>::infinity()),
+        object(nullptr),
+        primId(0),
+        bary(0.0f)
+        {}
+};
+
 class Hitable
 {
 public:
@@ -46,6 +73,14 @@ public:
     // estarà entre t_min i t_max
      virtual bool hit (Ray& r, float tmin, float tmax, HitInfo& info) const = 0;
 
+    // Consulta d'oclusió: retorna cert si hi ha alguna intersecció entre r.getTmin()
+    // i tmax, sense buscar la més propera. Per defecte fa servir hit(); els objectes
+    // compostos la sobreescriuen per acabar a la primera intersecció que troben
+    virtual bool occluded(Ray &r, float tmax) const {
+        HitInfo info;
+        return hit(r, r.getTmin(), tmax, info);
+    }
+
 
     // OPCIONAL: Mètode que retorna totes les interseccions que es troben al llarg del raig
     //    virtual bool allHits(const Ray& r, vector<shared_ptr<HitInfo> infos) const = 0;
@@ -54,7 +89,8 @@ public:
     static vec3 RandomInSphere() {
         vec3 p;
         do {
-            p = 2.0f*vec3(double(rand())/RAND_MAX, double(rand())/RAND_MAX,double(rand())/RAND_MAX) - vec3(1,1,1);
+            Random &rng = Random::local();
+            p = 2.0f*vec3(rng.nextFloat(), rng.nextFloat(), rng.nextFloat()) - vec3(1,1,1);
         } while (glm::length(p) >=  1.0f);
         return p;
     }
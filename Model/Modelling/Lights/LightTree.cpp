@@ -0,0 +1,127 @@
+#include "LightTree.hh"
+
+#include <algorithm>
+#include <cfloat>
+
+void LightTree::clear() {
+    nodes.clear();
+    pointLights.clear();
+    otherLights.clear();
+}
+
+void LightTree::build(const vector<shared_ptr<Light>> &lights) {
+    clear();
+    for (const shared_ptr<Light> &l : lights) {
+        PointLight *point = dynamic_cast<PointLight*>(l.get());
+        if (point) pointLights.push_back(point);
+        else otherLights.push_back(l.get());
+    }
+    if (pointLights.empty()) return;
+
+    vector<int> order(pointLights.size());
+    for (unsigned int i = 0; i < order.size(); i++) order[i] = i;
+    nodes.reserve(2 * pointLights.size() - 1);
+    buildRecursive(order, 0, (int)order.size());
+}
+
+int LightTree::buildRecursive(vector<int> &order, int start, int end) {
+    int index = (int)nodes.size();
+    nodes.push_back(Node());
+
+    Node node;
+    node.power = 0.0f;
+    node.minCoef = vec3(FLT_MAX);
+    node.attenuated = false;
+    node.unattenuated = false;
+    for (int i = start; i < end; i++) {
+        PointLight *l = pointLights[order[i]];
+        vec3 Id = l->getId();
+        vec3 coef = l->getAttenuationCoefficients();
+        node.bounds.expand(l->getPos());
+        node.power += std::max(Id.x + Id.y + Id.z, 0.0f);
+        // Mateix criteri que PointLight::attenuation()
+        if (abs(coef.x) < DBL_EPSILON && abs(coef.y) < DBL_EPSILON && abs(coef.z) < DBL_EPSILON) {
+            node.unattenuated = true;
+        } else {
+            node.attenuated = true;
+            node.minCoef = glm::min(node.minCoef, glm::max(coef, vec3(0.0f)));
+        }
+    }
+
+    if (end - start == 1) {
+        node.first = order[start];
+        node.right = -1;
+        nodes[index] = node;
+        return index;
+    }
+
+    // Divisió per la mediana de les posicions a l'eix més llarg
+    int axis = node.bounds.maxAxis();
+    int mid = (start + end) / 2;
+    std::nth_element(order.begin() + start, order.begin() + mid, order.begin() + end,
+                     [&](int a, int b) { return pointLights[a]->getPos()[axis] < pointLights[b]->getPos()[axis]; });
+
+    node.first = -1;
+    buildRecursive(order, start, mid);
+    node.right = buildRecursive(order, mid, end);
+    nodes[index] = node;
+    return index;
+}
+
+float LightTree::importance(const Node &node, const vec3 &p, const vec3 &normal) const {
+    // Cap punt de la capsa davant del pla tangent
+    vec3 far = glm::max(normal * node.bounds.pmin, normal * node.bounds.pmax);
+    if (far.x + far.y + far.z - dot(normal, p) <= 0.0f) return 0.0f;
+
+    vec3 closest = glm::clamp(p, node.bounds.pmin, node.bounds.pmax);
+    float d = distance(p, closest);
+
+    float att = node.unattenuated ? 1.0f : 0.0f;
+    if (node.attenuated) {
+        float den = (node.minCoef.z * d + node.minCoef.y) * d + node.minCoef.x;
+        att = std::max(att, 1.0f / std::max(den, 1e-6f));
+    }
+    return node.power * att;
+}
+
+int LightTree::sample(const vec3 &p, const vec3 &normal, Random &rng, int numSamples, LightSample out[]) const {
+    int count = 0;
+    for (Light *l : otherLights)
+        out[count++] = LightSample{l, 1.0f};
+    if (nodes.empty() || importance(nodes[0], p, normal) <= 0.0f) return count;
+
+    int first = count;
+    for (int s = 0; s < numSamples; s++) {
+        // Baixada des de l'arrel amb un sol nombre aleatori, que es reescala a cada nivell
+        float u = rng.nextFloat();
+        float pdf = 1.0f;
+        int   n = 0;
+        while (nodes[n].right >= 0) {
+            float left = importance(nodes[n + 1], p, normal);
+            float right = importance(nodes[nodes[n].right], p, normal);
+            // Cap llum del node pot il·luminar el punt: la mostra no aporta res
+            if (left + right <= 0.0f) break;
+            float pLeft = left / (left + right);
+            if (u < pLeft) {
+                u = u / pLeft;
+                pdf *= pLeft;
+                n = n + 1;
+            } else {
+                u = (u - pLeft) / (1.0f - pLeft);
+                pdf *= 1.0f - pLeft;
+                n = nodes[n].right;
+            }
+            u = std::min(u, 1.0f - FLT_EPSILON);
+        }
+
+        if (nodes[n].right >= 0) continue;
+
+        Light *light = pointLights[nodes[n].first];
+        float weight = 1.0f / (numSamples * pdf);
+        int i = first;
+        while (i < count && out[i].light != light) i++;
+        if (i < count) out[i].weight += weight;
+        else out[count++] = LightSample{light, weight};
+    }
+    return count;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include "Light.hh"
+#include "PointLight.hh"
+#include "Model/Modelling/AABB.hh"
+#include "Model/Modelling/Random.hh"
+
+// Llum escollida per il·luminar un punt. weight és el pes de la seva contribució:
+// 1 si es calculen totes les llums i 1/(N * pdf) si se n'han escollit N a l'atzar.
+// Un cop traçat el raig d'ombra, es multiplica per la visibilitat
+struct LightSample
+{
+    Light *light;
+    float  weight;
+};
+
+// Jerarquia de llums puntuals per escollir, per a cada punt, poques llums amb
+// probabilitat proporcional a una fita de la seva contribució (Id * atenuació).
+// Cada node guarda la capsa de les posicions, la suma de la intensitat difosa i els
+// coeficients d'atenuació més petits del subarbre. El mostreig baixa des de l'arrel
+// triant cada fill segons la seva importància, de manera que el cost és logarítmic
+// en el nombre de llums i l'estimació no té biaix.
+// Les llums que no són puntuals no entren a l'arbre i es calculen sempre.
+class LightTree
+{
+public:
+    LightTree() {};
+
+    void build(const vector<shared_ptr<Light>> &lights);
+    void clear();
+
+    // Escull numSamples llums puntuals per al punt p amb normal normal i hi afegeix
+    // totes les que no són puntuals. Les llums repetides s'ajunten en una sola
+    // mostra. Retorna les mostres escrites a out (com a molt maxSamples(numSamples))
+    int sample(const vec3 &p, const vec3 &normal, Random &rng, int numSamples, LightSample out[]) const;
+
+    int maxSamples(int numSamples) const { return numSamples + (int)otherLights.size(); }
+
+    int numPointLights() const { return (int)pointLights.size(); }
+
+private:
+    struct Node {
+        AABB  bounds;
+        float power;         // suma de les components de Id del subarbre
+        vec3  minCoef;       // coeficients a, b, c més petits de les llums atenuades
+        bool  attenuated;    // hi ha alguna llum amb atenuació
+        bool  unattenuated;  // hi ha alguna llum sense atenuació
+        int   first;         // fulla: índex de la llum a pointLights
+        int   right;         // node intern: fill dret (l'esquerre és el següent); fulla: -1
+    };
+
+    int   buildRecursive(vector<int> &order, int start, int end);
+
+    // Fita de la contribució de les llums del node al punt p: zero si totes queden
+    // darrere del pla tangent (no poden il·luminar el punt)
+    float importance(const Node &node, const vec3 &p, const vec3 &normal) const;
+
+    vector<Node>        nodes;
+    vector<PointLight*> pointLights;
+    vector<Light*>      otherLights;
+};
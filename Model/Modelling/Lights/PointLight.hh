@@ -21,6 +21,8 @@ public:
     PointLight(vec3 posicio, vec3 Ia, vec3 Id, vec3 Is, float a, float b, float c);
     virtual ~PointLight() {}
     vec3 getPos();
+    // Coeficients (a, b, c) de l'atenuació
+    vec3 getAttenuationCoefficients() const { return vec3(a, b, c); }
     virtual vec3 vectorL(vec3 point) override;
     virtual float attenuation(vec3 point) override;
     virtual float distanceToLight(vec3 point) override;
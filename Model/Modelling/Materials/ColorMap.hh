@@ -9,7 +9,7 @@ class ColorMap
 
  public:
 
-  virtual vec3 getColor(const double value) = 0;
+  virtual vec3 getColor(const double value) const = 0;
   // Comput [r,g,b] values of the selected colormap for
   // a given factor f between 0 and 1
   //
@@ -18,7 +18,7 @@ class ColorMap
   // Outputs:
   //   rgb  red, green, blue value
 
-  virtual void getColor(const double f, double *rgb) = 0;
+  virtual void getColor(const double f, double *rgb) const = 0;
 
   // Inputs:
   //   f  factor determining color value as if 0 was min and 1 was max
@@ -26,7 +26,7 @@ class ColorMap
   //   r  red value
   //   g  green value
   //   b  blue value
-  virtual void getColor(const double f, double & r, double & g, double & b) = 0;
+  virtual void getColor(const double f, double & r, double & g, double & b) const = 0;
 
 };
 
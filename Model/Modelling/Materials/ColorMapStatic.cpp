@@ -10,9 +10,10 @@
 // One of the new matplotlib colormaps by Nathaniel J.Smith, Stefan van der Walt, and (in the case of viridis) Eric Firing.
 // Released under the CC0 license / public domain dedication
 
+#include <algorithm>
 #include "ColorMapStatic.hh"
 
-static double custom_cm[256][3] = {
+static constexpr double custom_cm[256][3] = {
     {0.19074, 0.02388, 0.12621},
     {0.20881, 0.00526, 0.75515},
     {0.94834, 0.60623, 0.32080},
@@ -270,7 +271,7 @@ static double custom_cm[256][3] = {
     {0.25824, 0.12665, 0.06901},
     {0.17307, 0.77127, 0.85887}
 };
-static double inferno_cm[256][3] = {
+static constexpr double inferno_cm[256][3] = {
   { 0.001462, 0.000466, 0.013866 },
   { 0.002267, 0.001270, 0.018570 },
   { 0.003299, 0.002249, 0.024239 },
@@ -529,7 +530,7 @@ static double inferno_cm[256][3] = {
   { 0.988362, 0.998364, 0.644924 }
 };
 
-static double magma_cm[256][3] = {
+static constexpr double magma_cm[256][3] = {
   { 0.001462, 0.000466, 0.013866 },
   { 0.002258, 0.001295, 0.018331 },
   { 0.003279, 0.002305, 0.023708 },
@@ -788,7 +789,7 @@ static double magma_cm[256][3] = {
   { 0.987053, 0.991438, 0.749504 }
 };
 
-static double plasma_cm[256][3] = {
+static constexpr double plasma_cm[256][3] = {
   { 0.050383, 0.029803, 0.527975 },
   { 0.063536, 0.028426, 0.533124 },
   { 0.075353, 0.027206, 0.538007 },
@@ -1047,7 +1048,7 @@ static double plasma_cm[256][3] = {
   { 0.940015, 0.975158, 0.131326 }
 };
 
-static double viridis_cm[256][3] = {
+static constexpr double viridis_cm[256][3] = {
   { 0.267004, 0.004874, 0.329415 },
   { 0.268510, 0.009605, 0.335427 },
   { 0.269944, 0.014625, 0.341379 },
@@ -1306,7 +1307,7 @@ static double viridis_cm[256][3] = {
   { 0.993248, 0.906157, 0.143936 }
 };
 
-static double parula_cm[256][3] = {
+static constexpr double parula_cm[256][3] = {
   { 0.2081, 0.1663, 0.5292 },
   { 0.2091, 0.1721, 0.5411 },
   { 0.2101, 0.1779, 0.553   },
@@ -1565,6 +1566,286 @@ static double parula_cm[256][3] = {
   { 0.9763, 0.9831, 0.0538 }
 };
 
+// Paleta jet de MATLAB: r, g, b = clamp(1.5 - |4x - k|) amb k = 3, 2, 1
+static constexpr double jet_cm[256][3] = {
+    {0.00000, 0.00000, 0.50000},
+    {0.00000, 0.00000, 0.51569},
+    {0.00000, 0.00000, 0.53137},
+    {0.00000, 0.00000, 0.54706},
+    {0.00000, 0.00000, 0.56275},
+    {0.00000, 0.00000, 0.57843},
+    {0.00000, 0.00000, 0.59412},
+    {0.00000, 0.00000, 0.60980},
+    {0.00000, 0.00000, 0.62549},
+    {0.00000, 0.00000, 0.64118},
+    {0.00000, 0.00000, 0.65686},
+    {0.00000, 0.00000, 0.67255},
+    {0.00000, 0.00000, 0.68824},
+    {0.00000, 0.00000, 0.70392},
+    {0.00000, 0.00000, 0.71961},
+    {0.00000, 0.00000, 0.73529},
+    {0.00000, 0.00000, 0.75098},
+    {0.00000, 0.00000, 0.76667},
+    {0.00000, 0.00000, 0.78235},
+    {0.00000, 0.00000, 0.79804},
+    {0.00000, 0.00000, 0.81373},
+    {0.00000, 0.00000, 0.82941},
+    {0.00000, 0.00000, 0.84510},
+    {0.00000, 0.00000, 0.86078},
+    {0.00000, 0.00000, 0.87647},
+    {0.00000, 0.00000, 0.89216},
+    {0.00000, 0.00000, 0.90784},
+    {0.00000, 0.00000, 0.92353},
+    {0.00000, 0.00000, 0.93922},
+    {0.00000, 0.00000, 0.95490},
+    {0.00000, 0.00000, 0.97059},
+    {0.00000, 0.00000, 0.98627},
+    {0.00000, 0.00196, 1.00000},
+    {0.00000, 0.01765, 1.00000},
+    {0.00000, 0.03333, 1.00000},
+    {0.00000, 0.04902, 1.00000},
+    {0.00000, 0.06471, 1.00000},
+    {0.00000, 0.08039, 1.00000},
+    {0.00000, 0.09608, 1.00000},
+    {0.00000, 0.11176, 1.00000},
+    {0.00000, 0.12745, 1.00000},
+    {0.00000, 0.14314, 1.00000},
+    {0.00000, 0.15882, 1.00000},
+    {0.00000, 0.17451, 1.00000},
+    {0.00000, 0.19020, 1.00000},
+    {0.00000, 0.20588, 1.00000},
+    {0.00000, 0.22157, 1.00000},
+    {0.00000, 0.23725, 1.00000},
+    {0.00000, 0.25294, 1.00000},
+    {0.00000, 0.26863, 1.00000},
+    {0.00000, 0.28431, 1.00000},
+    {0.00000, 0.30000, 1.00000},
+    {0.00000, 0.31569, 1.00000},
+    {0.00000, 0.33137, 1.00000},
+    {0.00000, 0.34706, 1.00000},
+    {0.00000, 0.36275, 1.00000},
+    {0.00000, 0.37843, 1.00000},
+    {0.00000, 0.39412, 1.00000},
+    {0.00000, 0.40980, 1.00000},
+    {0.00000, 0.42549, 1.00000},
+    {0.00000, 0.44118, 1.00000},
+    {0.00000, 0.45686, 1.00000},
+    {0.00000, 0.47255, 1.00000},
+    {0.00000, 0.48824, 1.00000},
+    {0.00000, 0.50392, 1.00000},
+    {0.00000, 0.51961, 1.00000},
+    {0.00000, 0.53529, 1.00000},
+    {0.00000, 0.55098, 1.00000},
+    {0.00000, 0.56667, 1.00000},
+    {0.00000, 0.58235, 1.00000},
+    {0.00000, 0.59804, 1.00000},
+    {0.00000, 0.61373, 1.00000},
+    {0.00000, 0.62941, 1.00000},
+    {0.00000, 0.64510, 1.00000},
+    {0.00000, 0.66078, 1.00000},
+    {0.00000, 0.67647, 1.00000},
+    {0.00000, 0.69216, 1.00000},
+    {0.00000, 0.70784, 1.00000},
+    {0.00000, 0.72353, 1.00000},
+    {0.00000, 0.73922, 1.00000},
+    {0.00000, 0.75490, 1.00000},
+    {0.00000, 0.77059, 1.00000},
+    {0.00000, 0.78627, 1.00000},
+    {0.00000, 0.80196, 1.00000},
+    {0.00000, 0.81765, 1.00000},
+    {0.00000, 0.83333, 1.00000},
+    {0.00000, 0.84902, 1.00000},
+    {0.00000, 0.86471, 1.00000},
+    {0.00000, 0.88039, 1.00000},
+    {0.00000, 0.89608, 1.00000},
+    {0.00000, 0.91176, 1.00000},
+    {0.00000, 0.92745, 1.00000},
+    {0.00000, 0.94314, 1.00000},
+    {0.00000, 0.95882, 1.00000},
+    {0.00000, 0.97451, 1.00000},
+    {0.00000, 0.99020, 1.00000},
+    {0.00588, 1.00000, 0.99412},
+    {0.02157, 1.00000, 0.97843},
+    {0.03725, 1.00000, 0.96275},
+    {0.05294, 1.00000, 0.94706},
+    {0.06863, 1.00000, 0.93137},
+    {0.08431, 1.00000, 0.91569},
+    {0.10000, 1.00000, 0.90000},
+    {0.11569, 1.00000, 0.88431},
+    {0.13137, 1.00000, 0.86863},
+    {0.14706, 1.00000, 0.85294},
+    {0.16275, 1.00000, 0.83725},
+    {0.17843, 1.00000, 0.82157},
+    {0.19412, 1.00000, 0.80588},
+    {0.20980, 1.00000, 0.79020},
+    {0.22549, 1.00000, 0.77451},
+    {0.24118, 1.00000, 0.75882},
+    {0.25686, 1.00000, 0.74314},
+    {0.27255, 1.00000, 0.72745},
+    {0.28824, 1.00000, 0.71176},
+    {0.30392, 1.00000, 0.69608},
+    {0.31961, 1.00000, 0.68039},
+    {0.33529, 1.00000, 0.66471},
+    {0.35098, 1.00000, 0.64902},
+    {0.36667, 1.00000, 0.63333},
+    {0.38235, 1.00000, 0.61765},
+    {0.39804, 1.00000, 0.60196},
+    {0.41373, 1.00000, 0.58627},
+    {0.42941, 1.00000, 0.57059},
+    {0.44510, 1.00000, 0.55490},
+    {0.46078, 1.00000, 0.53922},
+    {0.47647, 1.00000, 0.52353},
+    {0.49216, 1.00000, 0.50784},
+    {0.50784, 1.00000, 0.49216},
+    {0.52353, 1.00000, 0.47647},
+    {0.53922, 1.00000, 0.46078},
+    {0.55490, 1.00000, 0.44510},
+    {0.57059, 1.00000, 0.42941},
+    {0.58627, 1.00000, 0.41373},
+    {0.60196, 1.00000, 0.39804},
+    {0.61765, 1.00000, 0.38235},
+    {0.63333, 1.00000, 0.36667},
+    {0.64902, 1.00000, 0.35098},
+    {0.66471, 1.00000, 0.33529},
+    {0.68039, 1.00000, 0.31961},
+    {0.69608, 1.00000, 0.30392},
+    {0.71176, 1.00000, 0.28824},
+    {0.72745, 1.00000, 0.27255},
+    {0.74314, 1.00000, 0.25686},
+    {0.75882, 1.00000, 0.24118},
+    {0.77451, 1.00000, 0.22549},
+    {0.79020, 1.00000, 0.20980},
+    {0.80588, 1.00000, 0.19412},
+    {0.82157, 1.00000, 0.17843},
+    {0.83725, 1.00000, 0.16275},
+    {0.85294, 1.00000, 0.14706},
+    {0.86863, 1.00000, 0.13137},
+    {0.88431, 1.00000, 0.11569},
+    {0.90000, 1.00000, 0.10000},
+    {0.91569, 1.00000, 0.08431},
+    {0.93137, 1.00000, 0.06863},
+    {0.94706, 1.00000, 0.05294},
+    {0.96275, 1.00000, 0.03725},
+    {0.97843, 1.00000, 0.02157},
+    {0.99412, 1.00000, 0.00588},
+    {1.00000, 0.99020, 0.00000},
+    {1.00000, 0.97451, 0.00000},
+    {1.00000, 0.95882, 0.00000},
+    {1.00000, 0.94314, 0.00000},
+    {1.00000, 0.92745, 0.00000},
+    {1.00000, 0.91176, 0.00000},
+    {1.00000, 0.89608, 0.00000},
+    {1.00000, 0.88039, 0.00000},
+    {1.00000, 0.86471, 0.00000},
+    {1.00000, 0.84902, 0.00000},
+    {1.00000, 0.83333, 0.00000},
+    {1.00000, 0.81765, 0.00000},
+    {1.00000, 0.80196, 0.00000},
+    {1.00000, 0.78627, 0.00000},
+    {1.00000, 0.77059, 0.00000},
+    {1.00000, 0.75490, 0.00000},
+    {1.00000, 0.73922, 0.00000},
+    {1.00000, 0.72353, 0.00000},
+    {1.00000, 0.70784, 0.00000},
+    {1.00000, 0.69216, 0.00000},
+    {1.00000, 0.67647, 0.00000},
+    {1.00000, 0.66078, 0.00000},
+    {1.00000, 0.64510, 0.00000},
+    {1.00000, 0.62941, 0.00000},
+    {1.00000, 0.61373, 0.00000},
+    {1.00000, 0.59804, 0.00000},
+    {1.00000, 0.58235, 0.00000},
+    {1.00000, 0.56667, 0.00000},
+    {1.00000, 0.55098, 0.00000},
+    {1.00000, 0.53529, 0.00000},
+    {1.00000, 0.51961, 0.00000},
+    {1.00000, 0.50392, 0.00000},
+    {1.00000, 0.48824, 0.00000},
+    {1.00000, 0.47255, 0.00000},
+    {1.00000, 0.45686, 0.00000},
+    {1.00000, 0.44118, 0.00000},
+    {1.00000, 0.42549, 0.00000},
+    {1.00000, 0.40980, 0.00000},
+    {1.00000, 0.39412, 0.00000},
+    {1.00000, 0.37843, 0.00000},
+    {1.00000, 0.36275, 0.00000},
+    {1.00000, 0.34706, 0.00000},
+    {1.00000, 0.33137, 0.00000},
+    {1.00000, 0.31569, 0.00000},
+    {1.00000, 0.30000, 0.00000},
+    {1.00000, 0.28431, 0.00000},
+    {1.00000, 0.26863, 0.00000},
+    {1.00000, 0.25294, 0.00000},
+    {1.00000, 0.23725, 0.00000},
+    {1.00000, 0.22157, 0.00000},
+    {1.00000, 0.20588, 0.00000},
+    {1.00000, 0.19020, 0.00000},
+    {1.00000, 0.17451, 0.00000},
+    {1.00000, 0.15882, 0.00000},
+    {1.00000, 0.14314, 0.00000},
+    {1.00000, 0.12745, 0.00000},
+    {1.00000, 0.11176, 0.00000},
+    {1.00000, 0.09608, 0.00000},
+    {1.00000, 0.08039, 0.00000},
+    {1.00000, 0.06471, 0.00000},
+    {1.00000, 0.04902, 0.00000},
+    {1.00000, 0.03333, 0.00000},
+    {1.00000, 0.01765, 0.00000},
+    {1.00000, 0.00196, 0.00000},
+    {0.98627, 0.00000, 0.00000},
+    {0.97059, 0.00000, 0.00000},
+    {0.95490, 0.00000, 0.00000},
+    {0.93922, 0.00000, 0.00000},
+    {0.92353, 0.00000, 0.00000},
+    {0.90784, 0.00000, 0.00000},
+    {0.89216, 0.00000, 0.00000},
+    {0.87647, 0.00000, 0.00000},
+    {0.86078, 0.00000, 0.00000},
+    {0.84510, 0.00000, 0.00000},
+    {0.82941, 0.00000, 0.00000},
+    {0.81373, 0.00000, 0.00000},
+    {0.79804, 0.00000, 0.00000},
+    {0.78235, 0.00000, 0.00000},
+    {0.76667, 0.00000, 0.00000},
+    {0.75098, 0.00000, 0.00000},
+    {0.73529, 0.00000, 0.00000},
+    {0.71961, 0.00000, 0.00000},
+    {0.70392, 0.00000, 0.00000},
+    {0.68824, 0.00000, 0.00000},
+    {0.67255, 0.00000, 0.00000},
+    {0.65686, 0.00000, 0.00000},
+    {0.64118, 0.00000, 0.00000},
+    {0.62549, 0.00000, 0.00000},
+    {0.60980, 0.00000, 0.00000},
+    {0.59412, 0.00000, 0.00000},
+    {0.57843, 0.00000, 0.00000},
+    {0.56275, 0.00000, 0.00000},
+    {0.54706, 0.00000, 0.00000},
+    {0.53137, 0.00000, 0.00000},
+    {0.51569, 0.00000, 0.00000},
+    {0.50000, 0.00000, 0.00000}
+};
+
+// Paleta del constructor per defecte: només les 5 primeres entrades
+static constexpr double default_cm[256][3] = {
+    {0.5, 0.2, 0.7},
+    {1.0, 0.0, 0.0},
+    {1.0, 0.0, 1.0},
+    {0.0, 1.0, 0.0},
+    {1.0, 1.0, 0.0}
+};
+
+// Taula de cada paleta, indexada per COLOR_MAP_TYPES
+static constexpr const double (*colorMapTables[ColorMapStatic::NUM_COLOR_MAP_TYPES])[3] = {
+    inferno_cm,
+    jet_cm,
+    magma_cm,
+    parula_cm,
+    plasma_cm,
+    viridis_cm,
+    custom_cm
+};
+
 ColorMapStatic::COLOR_MAP_TYPES ColorMapStatic::getColorMapType(QString name)
 {
     auto tipusColorMap = ColorMapStatic::COLOR_MAP_TYPE_INFERNO;
@@ -1618,44 +1899,51 @@ QString ColorMapStatic::getNameType(ColorMapStatic::COLOR_MAP_TYPES type) {
     }
     return name;
 }
-void ColorMapStatic::copia(double out[256][3], double in[256][3]) {
-    int i, j;
-    for (i= 0; i<256; i++) {
-        for (j=0; j<3; j++) {
-            out[i][j] = in[i][j];
-        }
-    }
+ColorMapStatic::ColorMapStatic()
+{
+    lut = default_cm;
+    fillFloatLut();
 }
 
 ColorMapStatic::ColorMapStatic(const COLOR_MAP_TYPES cm)
 {
-    switch (cm)
-    {
-      case COLOR_MAP_TYPE_INFERNO:
-        copia(lut, inferno_cm);
-        break;
-      case COLOR_MAP_TYPE_MAGMA:
-        copia(lut, magma_cm);
-        break;
-      case COLOR_MAP_TYPE_PARULA:
-        copia(lut, parula_cm);
-        break;
-      case COLOR_MAP_TYPE_PLASMA:
-       copia(lut, plasma_cm);
-        break;
-      case COLOR_MAP_TYPE_VIRIDIS:
-        copia(lut, viridis_cm);
-        break;
-      case COLOR_MAP_TYPE_CUSTOM:
-        copia(lut, custom_cm);
-        break;
-      default:
-         break;
-    }
+    // Com abans, un tipus desconegut deixa la paleta per defecte
+    lut = (cm >= 0 && cm < NUM_COLOR_MAP_TYPES) ? colorMapTables[cm] : default_cm;
+    fillFloatLut();
+}
+
+void ColorMapStatic::fillFloatLut() {
+    for (int i = 0; i < 256; i++)
+        for (int j = 0; j < 3; j++)
+            flut[i][j] = (float)lut[i][j];
+}
+
+const ColorMapStatic &ColorMapStatic::getInstance(const COLOR_MAP_TYPES cm) {
+    // Una instància per paleta per a tot el procés, creades el primer cop que es
+    // demanen (la inicialització d'estàtics locals és segura entre threads)
+    static const ColorMapStatic instances[NUM_COLOR_MAP_TYPES] = {
+        ColorMapStatic(COLOR_MAP_TYPE_INFERNO),
+        ColorMapStatic(COLOR_MAP_TYPE_JET),
+        ColorMapStatic(COLOR_MAP_TYPE_MAGMA),
+        ColorMapStatic(COLOR_MAP_TYPE_PARULA),
+        ColorMapStatic(COLOR_MAP_TYPE_PLASMA),
+        ColorMapStatic(COLOR_MAP_TYPE_VIRIDIS),
+        ColorMapStatic(COLOR_MAP_TYPE_CUSTOM)
+    };
+    return instances[(cm >= 0 && cm < NUM_COLOR_MAP_TYPES) ? cm : COLOR_MAP_TYPE_INFERNO];
+}
+
+vec3 ColorMapStatic::getInterpolatedColor(float f) const {
+    float x = glm::clamp(f, 0.0f, 1.0f) * 255.0f;
+    int i = std::min((int)x, 254);
+    float a = x - i;
+    return vec3(flut[i][0] + a * (flut[i+1][0] - flut[i][0]),
+                flut[i][1] + a * (flut[i+1][1] - flut[i][1]),
+                flut[i][2] + a * (flut[i+1][2] - flut[i][2]));
 }
 
 
-void ColorMapStatic::getColor(const double f, double & r, double & g, double & b) {
+void ColorMapStatic::getColor(const double f, double & r, double & g, double & b) const {
 
     r = lut[(int)f][0];
     g = lut[(int)f][1];
@@ -1663,11 +1951,13 @@ void ColorMapStatic::getColor(const double f, double & r, double & g, double & b
 
 }
 
-void ColorMapStatic::getColor(const double f, double *rgb) {
-     rgb = lut[(int)f];
+void ColorMapStatic::getColor(const double f, double *rgb) const {
+     rgb[0] = lut[(int)f][0];
+     rgb[1] = lut[(int)f][1];
+     rgb[2] = lut[(int)f][2];
 }
 
-vec3 ColorMapStatic::getColor(const double f) {
+vec3 ColorMapStatic::getColor(const double f) const {
      return  vec3(lut[(int)f][0], lut[(int)f][1],lut[(int)f][2]);
 }
 ColorMapStatic::~ColorMapStatic() {
@@ -27,16 +27,22 @@ public:
     NUM_COLOR_MAP_TYPES = 7
   } ;
 
-    double lut[256][3];
-
-    ColorMapStatic(): lut {{0.5, 0.2, 0.7},{ 1.0, 0.0, 0.0},
-    {1.0, 0.0, 1.0},
-    {0.0, 1.0, 0.0},
-    {1.0, 1.0, 0.0}} {}
+    // Paleta de 256 colors. Apunta a una de les taules constants de
+    // ColorMapStatic.cpp, compartides per totes les instàncies
+    const double (*lut)[3];
 
+    ColorMapStatic();
     ColorMapStatic(const COLOR_MAP_TYPES cm);
 
-  virtual vec3 getColor(const double value);
+    // Instància de la paleta cm compartida per tot el procés. És la que cal fer
+    // servir per mapejar dades: no fa cap reserva de memòria
+    static const ColorMapStatic &getInstance(const COLOR_MAP_TYPES cm);
+
+    // Color de la paleta per a f entre 0 (mínim) i 1 (màxim), interpolat
+    // linealment entre les dues entrades més properes. f es retalla a [0, 1]
+    vec3 getInterpolatedColor(float f) const;
+
+  virtual vec3 getColor(const double value) const;
   // Comput [r,g,b] values of the selected colormap for
   // a given factor f between 0 and 1
   //
@@ -45,20 +51,23 @@ public:
   //   f  factor determining color value as if 0 was min and 1 was max
   // Outputs:
   //   rgb  red, green, blue value
-   virtual void getColor(const double f, double *rgb);
+   virtual void getColor(const double f, double *rgb) const;
 
   // Outputs:
   //   r  red value
   //   g  green value
   //   b  blue value
-  virtual void getColor(const double f, double & r, double & g, double & b);
+  virtual void getColor(const double f, double & r, double & g, double & b) const;
 
   virtual ~ColorMapStatic();
   static ColorMapStatic::COLOR_MAP_TYPES getColorMapType(QString name);
   static QString getNameType(ColorMapStatic::COLOR_MAP_TYPES type);
 
 private:
-   void copia(double out[256][3] , double in[256][3] );
+   // Còpia en float de lut per a getInterpolatedColor()
+   float flut[256][3];
+
+   void fillFloatLut();
 
 };
 
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include "Material.hh"
+
+using namespace std;
+
+// Taula de materials de les estructures compilades per al render (PrimitiveStore,
+// SphereSet): cada material diferent rep un índex i les primitives en guarden
+// només l'índex. La cerca és per punter, en temps constant, perquè les escenes de
+// dades poden tenir tants materials com objectes.
+class MaterialTable
+{
+public:
+    MaterialTable() {};
+
+    void clear() {
+        materials.clear();
+        ids.clear();
+    }
+
+    // Índex del material. Els objectes d'un mateix material comparteixen índex
+    int id(const shared_ptr<Material> &material) {
+        auto found = ids.find(material.get());
+        if (found != ids.end()) return found->second;
+        int m = (int)materials.size();
+        ids[material.get()] = m;
+        materials.push_back(material);
+        return m;
+    }
+
+    Material *get(int id) const { return materials[id].get(); }
+
+    int size() const { return (int)materials.size(); }
+
+private:
+    vector<shared_ptr<Material>>         materials;
+    unordered_map<const Material*, int>  ids;
+};
@@ -18,111 +18,23 @@ Box::Box(float data) :Object(data) {
     center = (vertexMin + vertexMax) / 2.f;
 }
 
-bool Box::hit(Ray &raig, float tmin, float tmax, HitInfo& info) const {
-    /*
-     * Un cubo puede definirse mediante dos puntos correspondientes a las
-     * coordenadas de dos esquinas del cubo enfrentadas diagonalmente:
-     * vertexMin, vertexMax
-     *
-     * Para aplicar el algoritmo de Kay y Kajiya es mejor considerar
-     * un cubo canónico centrado en el origen y radio la unidad,
-     * vertex1 = (-1, -1, -1) y vertex2 = (1, 1, 1), y el rayo transformado
-     * R’(t) = PO’ + D’ * t, con punto origen PO’ = (POx’, POy’, POz’)
-     * y vector dirección unitario D’ = (dx’, dy’, dz’).
-     */
-
-    float EPSILON = 0.001;
-
-    // Para el eje x y el eje y
-    float t_x_Min = (vertexMin.x - raig.getOrigin().x) / raig.getDirection().x;
-    float t_x_Max = (vertexMax.x - raig.getOrigin().x) / raig.getDirection().x;
-
-    if(t_x_Min > t_x_Max){
-        float aux = t_x_Max;
-        t_x_Max = t_x_Min;
-        t_x_Min = aux;
-    }
-
-    float t_y_Min = (vertexMin.y - raig.getOrigin().y) / raig.getDirection().y;
-    float t_y_Max = (vertexMax.y - raig.getOrigin().y) / raig.getDirection().y;
-
-    if(t_y_Min > t_y_Max){
-        float aux = t_y_Max;
-        t_y_Max = t_y_Min;
-        t_y_Min = aux;
-    }
-
-    if ((t_x_Min > t_y_Max) || (t_y_Min > t_x_Max))
-        return false;
-
-    if (t_y_Min > t_x_Min)
-        t_x_Min = t_y_Min;
-
-    if (t_y_Max < t_x_Max)
-        t_x_Max = t_y_Max;
-
-    // Para el eje x y el eje z
-    float t_z_Min = (vertexMin.z - raig.getOrigin().z) / raig.getDirection().z;
-    float t_z_Max = (vertexMax.z - raig.getOrigin().z) / raig.getDirection().z;
-
-    if (t_z_Min > t_z_Max){
-        float aux = t_z_Max;
-        t_z_Max = t_z_Min;
-        t_z_Min = aux;
-    }
-
-    if ((t_x_Min > t_z_Max) || (t_z_Min > t_x_Max))
-        return false;
-
-    if (t_z_Min > t_x_Min)
-        t_x_Min = t_z_Min;
-
-    if (t_z_Max < t_x_Max)
-        t_x_Max = t_z_Max;
-
-    if(t_x_Min > tmin && t_x_Max < tmax){
-        info.t = t_x_Min;
-        info.p = raig.getOrigin() + (raig.getDirection() * t_x_Min);
-        info.mat_ptr = material.get();
-
-
-        /*La normal Ni’ en el punto de intersección es un vector unitario
-         * perpendicular a la cara intersectada:
-         *
-         * Cara anterior: Ni’ = (0, 0, -1)
-         * Cara posterior: Ni’ = (0, 0, 1)
-         * Cara superior: Ni’ = (0, 1, 0)
-         * Cara inferior: Ni’ = (0, -1, 0)
-         * Cara izquierda: Ni’ = (-1, 0, 0)
-         * Cara derecha: Ni’ = (1, 0, 0)
-         *
-         * De igual forma que en casos anteriores, la normal se corregirá para
-         * devolverla al espacio global de coordenadas de la escena, y si el
-         * rayo incide en alguna cara interior se tomará con el signo cambiado.
-         */
-
-        if(fabs(info.p.x - vertexMax.x) < EPSILON)
-            info.normal = vec3(1,0,0);
-
-        if(fabs(info.p.y - vertexMax.y) < EPSILON)
-            info.normal = vec3(0,1,0);
-
-        if(fabs(info.p.z - vertexMax.z) < EPSILON)
-            info.normal = vec3(0,0,1);
-
-        if(fabs(info.p.x - vertexMin.x) < EPSILON)
-            info.normal = vec3(-1,0,0);
-
-        if(fabs(info.p.y - vertexMin.y) < EPSILON)
-            info.normal = vec3(0,-1,0);
-
-        if(fabs(info.p.z - vertexMin.z) < EPSILON)
-            info.normal = vec3(0,0,-1);
+bool Box::intersect(const Ray &raig, float tmin, float tmax, HitRecord &rec) const {
+    return intersectSlabs(vertexMin, vertexMax, raig, tmin, tmax, rec);
+}
 
-        return true;
-    }
-    return false;
+void Box::finalize(const Ray &raig, const HitRecord &rec, HitInfo &info) const {
+    info.t = rec.t;
+    info.p = raig.pointAtParameter(rec.t);
+    info.mat_ptr = material.get();
+    info.normal = entryNormal(raig, rec.primId);
+}
 
+vec3 Box::entryNormal(const Ray &raig, int axis) {
+    // Normal de la cara d'entrada: en l'eix d'entrada, de signe contrari a la
+    // direcció del raig (cara de vertexMin si el raig avança en positiu)
+    vec3 normal(0.0f);
+    normal[axis] = raig.getSign(axis) ? 1.0f : -1.0f;
+    return normal;
 }
 
 
@@ -135,6 +47,11 @@ void Box::aplicaTG(shared_ptr<TG> t) {
     }
 }
 
+bool Box::boundingBox(AABB &box) const {
+    box = AABB(vertexMin, vertexMax);
+    return true;
+}
+
 void Box::read (const QJsonObject &json)
 {
     Object::read(json);
@@ -18,18 +18,25 @@ public:
 
     virtual ~Box() {}
 
-    virtual bool hit(Ray& r, float tmin, float tmax, HitInfo& info) const override;
+    virtual bool intersect(const Ray &r, float tmin, float tmax, HitRecord &rec) const override;
+    virtual void finalize(const Ray &r, const HitRecord &rec, HitInfo &info) const override;
+
+    // Interseccio i normal d'una capsa donada pels seus vèrtexs, sense objecte.
+    // Les fan servir intersect() i finalize() i el PrimitiveStore de l'escena
+    static bool intersectSlabs(const vec3 &vMin, const vec3 &vMax, const Ray &r, float tmin, float tmax, HitRecord &rec);
+    static vec3 entryNormal(const Ray &r, int axis);
 
     virtual void aplicaTG(shared_ptr<TG> tg) override;
+    virtual bool boundingBox(AABB &box) const override;
 
     virtual void read (const QJsonObject &json) override;
     virtual void write(QJsonObject &json) const override;
     virtual void print(int indentation) const override;
 
 
-    vec3 getVertexMin() { return vertexMin;};
-    vec3 getVertexMax() { return vertexMax;}
-    vec3 getCenter() { return center;}
+    vec3 getVertexMin() const { return vertexMin;};
+    vec3 getVertexMax() const { return vertexMax;}
+    vec3 getCenter() const { return center;}
 
 private:
     // vertice extremo min
@@ -39,3 +46,34 @@ private:
     // centro del cubo
     vec3 center;
 };
+
+
+inline bool Box::intersectSlabs(const vec3 &vertexMin, const vec3 &vertexMax, const Ray &raig,
+                                float tmin, float tmax, HitRecord &rec) {
+    /*
+     * Test de les slabs de Kay i Kajiya. Amb la inversa de la direcció i el
+     * signe de cada component, precalculats al raig, es tria directament quin
+     * pla de cada eix és el d'entrada i quin el de sortida: no hi ha divisions
+     * ni intercanvis.
+     */
+    vec3 origin = raig.getOrigin();
+    const vec3 &invDir = raig.getInvDirection();
+    vec3 t0 = (vertexMin - origin) * invDir;
+    vec3 t1 = (vertexMax - origin) * invDir;
+    vec3 tnear = glm::min(t0, t1);
+    vec3 tfar = glm::max(t0, t1);
+
+    // El raig entra a la capsa per l'eix amb la tnear més gran
+    int axis = (tnear.y > tnear.x) ? 1 : 0;
+    axis = (tnear.z > tnear[axis]) ? 2 : axis;
+    float tEnter = tnear[axis];
+    float tExit = glm::min(glm::min(tfar.x, tfar.y), tfar.z);
+
+    if (tEnter > tExit || tEnter <= tmin || tEnter >= tmax)
+        return false;
+
+    // La primitiva és l'eix de la cara d'entrada
+    rec.t = tEnter;
+    rec.primId = axis;
+    return true;
+}
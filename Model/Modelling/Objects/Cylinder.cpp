@@ -22,7 +22,12 @@ Cylinder::Cylinder(float data) :Object(data) {
 
 
 
-bool Cylinder::hit(Ray &raig, float tmin, float tmax, HitInfo& info) const {
+bool Cylinder::intersect(const Ray &raig, float tmin, float tmax, HitRecord &rec) const {
+    return intersectVertical(center, radius, height, raig, tmin, tmax, rec);
+}
+
+bool Cylinder::intersectVertical(const vec3 &center, float radius, float height,
+                                 const Ray &raig, float tmin, float tmax, HitRecord &rec) {
     float a,b,c;
     float rx,rz;
     float jx, jz;
@@ -111,30 +116,39 @@ bool Cylinder::hit(Ray &raig, float tmin, float tmax, HitInfo& info) const {
         if(min==HUGE_VALF || min < tmin || min>tmax){
             return false;
         }
-        info.t = min;
-        info.p = raig.pointAtParameter(info.t);
-        info.mat_ptr = material.get();
-
-        //Si la intersección seleccionada es con la superficie curva...
-        if(index_min<2){
-            /* Calculamos la normal como si el punto de intersección estuviera a la altura de la misma
-             * base del cilindro. */
-            info.normal = (vec3(info.p.x,center.y,info.p.z)-center)/radius;
-        }
-        //Si la intersección es con la tapa inferior
-        else if(index_min==2){
-            info.normal = vec3(0,-1,0);
-        }
-        //Si la intersección es con la tapa superior
-        else{
-            info.normal = vec3(0,1,0);
-        }
+        // La primitiva és la superfície tallada: 0 i 1 la corba, 2 i 3 les tapes
+        rec.t = min;
+        rec.primId = index_min;
         return true;
     }
 
     return false;
 }
 
+void Cylinder::finalize(const Ray &raig, const HitRecord &rec, HitInfo &info) const {
+    info.t = rec.t;
+    info.p = raig.pointAtParameter(info.t);
+    info.mat_ptr = material.get();
+    info.normal = surfaceNormal(center, radius, info.p, rec.primId);
+}
+
+vec3 Cylinder::surfaceNormal(const vec3 &center, float radius, const vec3 &p, int surface) {
+    //Si la intersección seleccionada es con la superficie curva...
+    if(surface<2){
+        /* Calculamos la normal como si el punto de intersección estuviera a la altura de la misma
+         * base del cilindro. */
+        return (vec3(p.x,center.y,p.z)-center)/radius;
+    }
+    //Si la intersección es con la tapa inferior
+    else if(surface==2){
+        return vec3(0,-1,0);
+    }
+    //Si la intersección es con la tapa superior
+    else{
+        return vec3(0,1,0);
+    }
+}
+
 
 void Cylinder::aplicaTG(shared_ptr<TG> t) {
     if (dynamic_pointer_cast<TranslateTG>(t)) {
@@ -147,6 +161,13 @@ void Cylinder::aplicaTG(shared_ptr<TG> t) {
 
 }
 
+bool Cylinder::boundingBox(AABB &box) const {
+    // L'eix del cilindre és vertical i la base és a l'altura del centre
+    box = AABB(vec3(center.x - radius, center.y, center.z - radius),
+               vec3(center.x + radius, center.y + height, center.z + radius));
+    return true;
+}
+
 
 void Cylinder::read (const QJsonObject &json)
 {
@@ -12,16 +12,25 @@ public:
 
     virtual ~Cylinder() {}
 
-    virtual bool hit(Ray& r, float tmin, float tmax, HitInfo& info) const override;
+    virtual bool intersect(const Ray &r, float tmin, float tmax, HitRecord &rec) const override;
+    virtual void finalize(const Ray &r, const HitRecord &rec, HitInfo &info) const override;
+
+    // Interseccio i normal d'un cilindre vertical donat per la base, el radi i
+    // l'altura, sense objecte. Les fan servir intersect() i finalize() i el
+    // PrimitiveStore de l'escena
+    static bool intersectVertical(const vec3 &center, float radius, float height,
+                                  const Ray &r, float tmin, float tmax, HitRecord &rec);
+    static vec3 surfaceNormal(const vec3 &center, float radius, const vec3 &p, int surface);
     virtual void aplicaTG(shared_ptr<TG> tg) override;
+    virtual bool boundingBox(AABB &box) const override;
 
     virtual void read (const QJsonObject &json) override;
     virtual void write(QJsonObject &json) const override;
     virtual void print(int indentation) const override;
 
-    vec3  getCenter() { return center;};
-    float getRadius() { return radius;};
-    float getHeight() { return height;}
+    vec3  getCenter() const { return center;};
+    float getRadius() const { return radius;};
+    float getHeight() const { return height;}
 
 private:
     // Centro del cilindro
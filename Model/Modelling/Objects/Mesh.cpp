@@ -2,6 +2,8 @@
 #include <QVector3D>
 
 #include "Mesh.hh"
+#include "Triangle.hh"
+#include "DataInOut/MeshCache.hh"
 
 Mesh::Mesh(const QString &fileName): Object()
 {
@@ -16,81 +18,125 @@ Mesh::Mesh(const QString &fileName, float data): Object(data)
 }
 
 Mesh::~Mesh() {
-    if (cares.size() > 0) cares.clear();
+    if (indexs.size() > 0) indexs.clear();
     if (vertexs.size() > 0) vertexs.clear();
 
 }
 
 void Mesh::makeTriangles() {
-    // TO DO Fase 1: A implementar
+    // Construeix el BVH de triangles a partir de les capses de cada triangle
+    int nTriangles = indexs.size() / 3;
+    vector<AABB> bounds(nTriangles);
+    for (int i = 0; i < nTriangles; i++) {
+        bounds[i].expand(vertexs[indexs[3*i]]);
+        bounds[i].expand(vertexs[indexs[3*i+1]]);
+        bounds[i].expand(vertexs[indexs[3*i+2]]);
+    }
+    bvh.build(bounds);
+}
+
+// Interseccio raig-triangle amb el test estanc de Triangle. Els vèrtexs es llegeixen
+// compartits de vertexs: els triangles veïns fan servir exactament els mateixos
+// valors i no queden escletxes entre ells. Per això no es guarden arestes per
+// triangle, que a més triplicarien la memòria de la geometria
+bool Mesh::hitTriangle(const Ray &r, int tri, float tmin, float tmax, HitRecord &rec) const {
+    return Triangle::intersectVertices(vertexs[indexs[3*tri]], vertexs[indexs[3*tri+1]],
+                                       vertexs[indexs[3*tri+2]], r, tmin, tmax, rec);
+}
+
+
+bool Mesh::intersect(const Ray &raig, float tmin, float tmax, HitRecord &rec) const {
+
+    int   closest = -1;
+    float t = tmax;
+    HitRecord hit;
+    bvh.traverse(raig, tmin, t, [&](int tri, float t0, float &t1) {
+        if (hitTriangle(raig, tri, t0, t1, hit)) {
+            t1 = hit.t;
+            rec.bary = hit.bary;
+            closest = tri;
+            return true;
+        }
+        return false;
+    });
+    if (closest < 0) return false;
+
+    rec.t = t;
+    rec.primId = closest;
+    return true;
 }
 
 
-bool Mesh::hit(Ray &raig, float tmin, float tmax, HitInfo& info) const {
+void Mesh::finalize(const Ray &raig, const HitRecord &rec, HitInfo &info) const {
+    int   closest = rec.primId;
+    float u = rec.bary.x, v = rec.bary.y;
+    const vec3 &v0 = vertexs[indexs[3*closest]];
+    const vec3 &v1 = vertexs[indexs[3*closest+1]];
+    const vec3 &v2 = vertexs[indexs[3*closest+2]];
+
+    info.t = rec.t;
+    info.p = raig.pointAtParameter(rec.t);
+
+    // Si l'obj porta normals (o coordenades de textura) s'interpolen amb les
+    // coordenades baricentriques del punt
+    const int *n = normalIndexs.empty() ? nullptr : &normalIndexs[3*closest];
+    if (n != nullptr && n[0] >= 0 && n[1] >= 0 && n[2] >= 0)
+        info.normal = normalize((1.0f - u - v)*normals[n[0]] + u*normals[n[1]] + v*normals[n[2]]);
+    else
+        info.normal = normalize(cross(v1 - v0, v2 - v0));
+
+    const int *uv = texIndexs.empty() ? nullptr : &texIndexs[3*closest];
+    if (uv != nullptr && uv[0] >= 0 && uv[1] >= 0 && uv[2] >= 0)
+        info.uv = (1.0f - u - v)*texCoords[uv[0]] + u*texCoords[uv[1]] + v*texCoords[uv[2]];
+    info.bary = rec.bary;
+    info.mat_ptr = material.get();
+}
 
-    // TODO Fase 1: A implementar
-    return false;
 
+bool Mesh::occluded(Ray &raig, float tmax) const {
+    return bvh.any(raig, raig.getTmin(), tmax, [&](int tri, float t0, float t1) {
+        HitRecord hit;
+        return hitTriangle(raig, tri, t0, t1, hit);
+    });
 }
 
 
 void Mesh::aplicaTG(shared_ptr<TG> t) {
-    // TO DO: Fase 1
+    // Es transformen tots els vertexs i es torna a construir el BVH
+    mat4 m = t->getTG();
+    for (unsigned int i = 0; i < vertexs.size(); i++) {
+        vec4 v = m * vec4(vertexs[i], 1.0f);
+        vertexs[i] = vec3(v.x, v.y, v.z);
+    }
+    // Les normals es transformen amb la inversa transposada
+    mat3 nm = transpose(inverse(mat3(m)));
+    for (unsigned int i = 0; i < normals.size(); i++)
+        normals[i] = normalize(nm * normals[i]);
+    makeTriangles();
+}
+
+bool Mesh::boundingBox(AABB &box) const {
+    box = bvh.getBounds();
+    return !box.isEmpty();
 }
 
 void Mesh::load (QString fileName) {
-    QFile file(fileName);
-    if(file.exists()) {
-        if(file.open(QFile::ReadOnly | QFile::Text)) {
-            while(!file.atEnd()) {
-                QString line = file.readLine().trimmed();
-                QStringList lineParts = line.split(QRegularExpression("\\s+"));
-                if(lineParts.count() > 0) {
-                    // if it’s a comment
-                    if(lineParts.at(0).compare("#", Qt::CaseInsensitive) == 0)
-                    {
-                        // qDebug() << line.remove(0, 1).trimmed();
-                    }
-
-                    // if it’s a vertex position (v)
-                    else if(lineParts.at(0).compare("v", Qt::CaseInsensitive) == 0)
-                    {
-                        vertexs.push_back(vec4(lineParts.at(1).toFloat(),
-                                               lineParts.at(2).toFloat(),
-                                               lineParts.at(3).toFloat(), 1.0f));
-                    }
-
-                    // if it’s a normal (vn)
-                    else if(lineParts.at(0).compare("vn", Qt::CaseInsensitive) == 0)
-                    {
-
-                    }
-                    // if it’s a texture (vt)
-                    else if(lineParts.at(0).compare("vt", Qt::CaseInsensitive) == 0)
-                    {
-
-                    }
-
-                    // if it’s face data (f)
-                    // there’s an assumption here that faces are all triangles
-                    else if(lineParts.at(0).compare("f", Qt::CaseInsensitive) == 0)
-                    {
-                        Face *face = new Face();
-
-                        // get points from v array
-                        face->idxVertices.push_back(lineParts.at(1).split("/").at(0).toInt() - 1);
-                        face->idxVertices.push_back(lineParts.at(2).split("/").at(0).toInt() - 1);
-                        face->idxVertices.push_back(lineParts.at(3).split("/").at(0).toInt() - 1);
-
-                        cares.push_back(*face);
-                    }
-                }
-            }
-            file.close();
-        } else {
-            qWarning("Boundary object file can not be opened.");
-        }
-    } else  qWarning("Boundary object file not found.");
+    // Si hi ha una cache binària al dia no cal parsejar l'obj ni construir el BVH
+    MeshCache cache(fileName);
+    if (cache.read(*this)) return;
+
+    ObjReader reader;
+    bool loaded = reader.load(fileName);
+
+    vertexs.swap(reader.positions);
+    indexs.swap(reader.indexs);
+    normals.swap(reader.normals);
+    normalIndexs.swap(reader.normalIndexs);
+    texCoords.swap(reader.texCoords);
+    texIndexs.swap(reader.texIndexs);
+    makeTriangles();
+
+    if (loaded) cache.write(*this);
 }
 
 void Mesh::read (const QJsonObject &json)
@@ -5,8 +5,6 @@
 #include <limits>
 
 #include <QString>
-#include <QFile>
-#include <QRegularExpression>
 
 
 #include <iostream>
@@ -14,7 +12,8 @@
 #include <cstring>
 
 #include "Object.hh"
-#include "Face.hh"
+#include "Model/Modelling/BVH.hh"
+#include "DataInOut/ObjReader.hh"
 
 using namespace std;
 
@@ -24,10 +23,14 @@ public:
     Mesh() {};
     Mesh(const QString &fileName);
     Mesh(const QString &fileName, float data);
-    virtual bool hit( Ray& r, float tmin, float tmax, HitInfo& info) const override;
+    // La primitiva és el triangle
+    virtual bool intersect(const Ray &r, float tmin, float tmax, HitRecord &rec) const override;
+    virtual void finalize(const Ray &r, const HitRecord &rec, HitInfo &info) const override;
+    virtual bool occluded(Ray &r, float tmax) const override;
 
 
     virtual void aplicaTG(shared_ptr<TG> tg) override;
+    virtual bool boundingBox(AABB &box) const override;
 
     virtual void read (const QJsonObject &json) override;
     virtual void write(QJsonObject &json) const override;
@@ -35,13 +38,25 @@ public:
 
     virtual ~Mesh();
 private:
+    friend class MeshCache;
 
 
     QString nom;
-    vector<Face> cares; // facees o cares de l'objecte
-    vector<vec4> vertexs; // vertexs de l'objecte sense repetits
+    vector<vec3> vertexs; // vertexs de l'objecte sense repetits
+    // triangles de l'objecte: 3 indexs a vertexs per triangle, tots seguits.
+    // Les cares de més de 3 vertexs es triangulen en ventall en carregar-les
+    vector<unsigned int> indexs;
+    // normals i coordenades de textura per vertex de cada triangle (paral·lels a
+    // indexs, -1 si no en té). Buits si l'obj no en porta
+    vector<vec3> normals;
+    vector<int>  normalIndexs;
+    vector<vec2> texCoords;
+    vector<int>  texIndexs;
+    // BVH sobre els triangles, construit un cop s'ha carregat la malla
+    BVH bvh;
 
     void load(QString filename);
     void makeTriangles();
+    bool hitTriangle(const Ray &r, int tri, float tmin, float tmax, HitRecord &rec) const;
 };
 
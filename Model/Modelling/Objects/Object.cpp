@@ -12,6 +12,18 @@ Object::Object(float d)
     material = nullptr;
   }
 
+bool Object::hit(Ray &r, float tmin, float tmax, HitInfo &info) const {
+    HitRecord rec;
+    if (!intersect(r, tmin, tmax, rec)) return false;
+    finalize(r, rec, info);
+    return true;
+}
+
+bool Object::occluded(Ray &r, float tmax) const {
+    HitRecord rec;
+    return intersect(r, r.getTmin(), tmax, rec);
+}
+
 float Object::getData() {
     return data;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Model/Modelling/Ray.hh"
+#include "Model/Modelling/AABB.hh"
 #include "Model/Modelling/Hitable.hh"
 #include "Model/Modelling/Animation.hh"
 
@@ -19,9 +20,26 @@ class Object: public Hitable, public Animable, public Serializable {
     virtual ~Object() {};
 
     // Metodes a implementar en les classes filles: son  metodes abstractes
-    virtual bool hit(Ray& r, float tmin, float tmax, HitInfo& info) const override = 0;
+
+    // Fase barata de la intersecció: si el raig talla l'objecte dins de (tmin, tmax)
+    // deixa a rec la t, la primitiva i les baricentriques i retorna cert. Si no, no
+    // modifica rec. No cal omplir rec.object: ho fa qui crida
+    virtual bool intersect(const Ray &r, float tmin, float tmax, HitRecord &rec) const = 0;
+
+    // Omple info (t, punt, normal, coordenades de textura i material) a partir del
+    // resultat de intersect(). Només es crida per a la intersecció més propera
+    virtual void finalize(const Ray &r, const HitRecord &rec, HitInfo &info) const = 0;
+
     virtual void aplicaTG(shared_ptr<TG>) override = 0 ;
 
+    // intersect() seguit de finalize()
+    virtual bool hit(Ray& r, float tmin, float tmax, HitInfo& info) const override;
+    virtual bool occluded(Ray &r, float tmax) const override;
+
+    // Capsa contenidora de l'objecte. Retorna fals si l'objecte no és afitat (plans)
+    // i, per tant, no es pot posar en el BVH de l'escena
+    virtual bool boundingBox(AABB &box) const = 0;
+
     // OPCIONAL: Mètode que retorna totes les interseccions de l'objecte
     //    virtual bool allHits(const Ray& r, vector<shared_ptr<HitInfo> infos) const = 0;
 
@@ -18,7 +18,7 @@ Plane::Plane(vec3 normal, float d, float v) : Object(v) {
         this->point = vec3(-d/normal.x, 0.0, 0.0);
 };
 
-bool Plane::hit(Ray &raig, float tmin, float tmax, HitInfo &info) const{
+bool Plane::intersect(const Ray &raig, float tmin, float tmax, HitRecord &rec) const{
     // Comprovem interseccio entre el pla i el raig
 
     // Comprovem si el normal al pla i el raig son ortogonals.
@@ -46,19 +46,24 @@ bool Plane::hit(Ray &raig, float tmin, float tmax, HitInfo &info) const{
 
     temp/= normal[0]*vp[0] + normal[1]*vp[1] + normal[2]*vp[2];
 
-    // Retornem false si no estem en el rang demanat
-    if (temp < tmax && temp > tmin) {
+    // Retornem false si no estem en el rang obert (tmin, tmax), com a la resta
+    // d'objectes. També si el raig és paral·lel al pla i temp és NaN
+    if (!(temp < tmax && temp > tmin)) {
         return false;
     }
 
+    rec.t = temp;
+    return true;
+}
+
+void Plane::finalize(const Ray &raig, const HitRecord &rec, HitInfo &info) const {
     // Omplim el camp de info:
-    info.t = temp;
+    info.t = rec.t;
     info.p = raig.pointAtParameter(info.t);
 
     // La normal a un pla es la mateixa per tots els punts
     info.normal = normal;
     info.mat_ptr = material.get();
-    return true;
 }
 
 
@@ -74,6 +79,11 @@ void Plane::aplicaTG(shared_ptr<TG> t) {
     }
 }
 
+bool Plane::boundingBox(AABB &box) const {
+    // Un pla no és afitat: es queda fora del BVH de l'escena
+    return false;
+}
+
 void Plane::read (const QJsonObject &json)
 {
     Object::read(json);
@@ -14,9 +14,11 @@ public:
     Plane(vec3 normal, float d, float v);
 
     virtual ~Plane(){}
-    virtual bool hit(Ray &r, float tmin, float tmax, HitInfo &info) const override;
+    virtual bool intersect(const Ray &r, float tmin, float tmax, HitRecord &rec) const override;
+    virtual void finalize(const Ray &r, const HitRecord &rec, HitInfo &info) const override;
 
     virtual void aplicaTG(shared_ptr<TG> tg) override;
+    virtual bool boundingBox(AABB &box) const override;
 
 
     virtual void read (const QJsonObject &json) override;
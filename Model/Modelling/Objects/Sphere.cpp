@@ -15,37 +15,36 @@ Sphere::Sphere(float data) :Object(data) {
     radius = 1.0f;
 }
 
-bool Sphere::hit(Ray &raig, float tmin, float tmax, HitInfo& info) const {
+bool Sphere::intersect(const Ray &raig, float tmin, float tmax, HitRecord &rec) const {
     vec3 oc = raig.getOrigin() - center;
     float a = dot(raig.getDirection(), raig.getDirection());
     float b = dot(oc, raig.getDirection());
     float c = dot(oc, oc) - radius*radius;
     float discriminant = b*b - a*c;
     if (discriminant > 0) {
-        float temp = (-b - sqrt(discriminant))/a;
+        float root = sqrt(discriminant);
+        float temp = (-b - root)/a;
         if (temp < tmax && temp > tmin) {
-            info.t = temp;
-            info.p = raig.pointAtParameter(info.t);
-            info.normal = (info.p - center) / radius;
-            info.mat_ptr = material.get();
-            // TODO Fase 3: Cal calcular les coordenades de textura
-
+            rec.t = temp;
             return true;
         }
-        temp = (-b + sqrt(discriminant)) / a;
+        temp = (-b + root) / a;
         if (temp < tmax && temp > tmin) {
-            info.t = temp;
-            info.p = raig.pointAtParameter(info.t);
-            info.normal = (info.p - center) / radius;
-            info.mat_ptr = material.get();
-            // TODO Fase 3: Cal calcular les coordenades de textura
-
+            rec.t = temp;
             return true;
         }
     }
     return false;
 }
 
+void Sphere::finalize(const Ray &raig, const HitRecord &rec, HitInfo &info) const {
+    info.t = rec.t;
+    info.p = raig.pointAtParameter(info.t);
+    info.normal = (info.p - center) / radius;
+    info.mat_ptr = material.get();
+    // TODO Fase 3: Cal calcular les coordenades de textura
+}
+
 
 void Sphere::aplicaTG(shared_ptr<TG> t) {
     if (dynamic_pointer_cast<TranslateTG>(t)) {
@@ -58,6 +57,11 @@ void Sphere::aplicaTG(shared_ptr<TG> t) {
 
 }
 
+bool Sphere::boundingBox(AABB &box) const {
+    box = AABB(center - vec3(radius), center + vec3(radius));
+    return true;
+}
+
 void Sphere::read (const QJsonObject &json)
 {
     Object::read(json);
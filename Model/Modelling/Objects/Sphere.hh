@@ -17,16 +17,18 @@ public:
     //Crea una esfera unitaria centrada al punt (0,0,0) i de radi 1
     Sphere(float data);
     virtual ~Sphere() {}
-    virtual bool hit(Ray& r, float tmin, float tmax, HitInfo& info) const override;
+    virtual bool intersect(const Ray &r, float tmin, float tmax, HitRecord &rec) const override;
+    virtual void finalize(const Ray &r, const HitRecord &rec, HitInfo &info) const override;
     virtual void aplicaTG(shared_ptr<TG> tg) override;
+    virtual bool boundingBox(AABB &box) const override;
 
     virtual void read (const QJsonObject &json) override;
     virtual void write(QJsonObject &json) const override;
     virtual void print(int indentation) const override;
 
 
-    vec3  getCenter() { return center;};
-    float getRadius() { return radius;}
+    vec3  getCenter() const { return center;};
+    float getRadius() const { return radius;}
 
 private:
     // Centre de l'esfera
@@ -0,0 +1,179 @@
+#include "SphereSet.hh"
+
+void SphereSet::clear() {
+    cx.clear(); cy.clear(); cz.clear();
+    radius.clear(); radius2.clear();
+    materialIndex.clear();
+    materials.clear();
+    bvh.clear();
+}
+
+void SphereSet::add(const Sphere &sphere, shared_ptr<Material> material) {
+    vec3 c = sphere.getCenter();
+    float r = sphere.getRadius();
+    cx.push_back(c.x);
+    cy.push_back(c.y);
+    cz.push_back(c.z);
+    radius.push_back(r);
+    radius2.push_back(r*r);
+
+    materialIndex.push_back(materials.id(material));
+}
+
+void SphereSet::build() {
+    int n = size();
+    cx.resize(n); cy.resize(n); cz.resize(n); radius2.resize(n);
+
+    vector<AABB> bounds(n);
+    for (int i = 0; i < n; i++) {
+        vec3 c(cx[i], cy[i], cz[i]);
+        bounds[i] = AABB(c - vec3(radius[i]), c + vec3(radius[i]));
+    }
+    bvh.build(bounds, LEAF_SIZE, SimdFloat::SIZE);
+
+    // Les esferes de cada fulla queden seguides: la fulla leftFirst..leftFirst+count
+    // indexa directament els vectors
+    vector<float> ox(cx), oy(cy), oz(cz), orad(radius), orad2(radius2);
+    vector<int>   omat(materialIndex);
+    for (int i = 0; i < n; i++) {
+        int p = bvh.primIndices[i];
+        cx[i] = ox[p]; cy[i] = oy[p]; cz[i] = oz[p];
+        radius[i] = orad[p]; radius2[i] = orad2[p];
+        materialIndex[i] = omat[p];
+        bvh.primIndices[i] = i;
+    }
+
+    // Farciment per a la darrera fulla. Els lanes de més no es fan servir mai
+    cx.resize(n + SimdFloat::SIZE, 0.0f); cy.resize(n + SimdFloat::SIZE, 0.0f);
+    cz.resize(n + SimdFloat::SIZE, 0.0f);
+    radius2.resize(n + SimdFloat::SIZE, 0.0f);
+}
+
+SphereSet::RayLanes::RayLanes(const Ray &r):
+    ox(r.getOrigin().x), oy(r.getOrigin().y), oz(r.getOrigin().z),
+    dx(r.getDirection().x), dy(r.getDirection().y), dz(r.getDirection().z),
+    a(dot(r.getDirection(), r.getDirection()))
+{}
+
+int SphereSet::hitLeaf(const RayLanes &r, int first, int count, float tmin, float &tmax) const {
+    SimdFloat zero(0.0f), vtmin(tmin);
+
+    int best = -1;
+    for (int i = first; i < first + count; i += SimdFloat::SIZE) {
+        // Mateixes operacions que Sphere::hit
+        SimdFloat ocx = r.ox - SimdFloat::load(&cx[i]);
+        SimdFloat ocy = r.oy - SimdFloat::load(&cy[i]);
+        SimdFloat ocz = r.oz - SimdFloat::load(&cz[i]);
+        SimdFloat b = ocx*r.dx + ocy*r.dy + ocz*r.dz;
+        SimdFloat c = (ocx*ocx + ocy*ocy + ocz*ocz) - SimdFloat::load(&radius2[i]);
+        SimdFloat disc = b*b - r.a*c;
+
+        int lanes = first + count - i;
+        int valid = lessMask(zero, disc);
+        if (lanes < SimdFloat::SIZE) valid &= (1 << lanes) - 1;
+        if (valid == 0) continue;
+
+        SimdFloat root = simdSqrt(disc);
+        SimdFloat t1 = (-b - root) / r.a;
+        SimdFloat t2 = (-b + root) / r.a;
+        SimdFloat vtmax(tmax);
+        int near = valid & lessMask(t1, vtmax) & lessMask(vtmin, t1);
+        int far = valid & ~near & lessMask(t2, vtmax) & lessMask(vtmin, t2);
+        if ((near | far) == 0) continue;
+
+        float tn[SimdFloat::SIZE], tf[SimdFloat::SIZE];
+        t1.store(tn);
+        t2.store(tf);
+        for (int k = 0; k < SimdFloat::SIZE; k++) {
+            float t;
+            if (near & (1 << k)) t = tn[k];
+            else if (far & (1 << k)) t = tf[k];
+            else continue;
+            if (t < tmax) {
+                tmax = t;
+                best = i + k;
+            }
+        }
+    }
+    return best;
+}
+
+bool SphereSet::intersect(const Ray &raig, float tmin, float tmax, HitRecord &rec) const {
+    RayLanes lanes(raig);
+    int best = -1;
+    float t = tmax;
+    bvh.traverseLeaves(raig, tmin, t, [&](int first, int count, float t0, float &t1) {
+        int s = hitLeaf(lanes, first, count, t0, t1);
+        if (s < 0) return false;
+        best = s;
+        return true;
+    });
+    if (best < 0) return false;
+    rec.t = t;
+    rec.primId = best;
+    return true;
+}
+
+bool SphereSet::occluded(Ray &raig, float tmax) const {
+    RayLanes lanes(raig);
+    return bvh.anyLeaves(raig, raig.getTmin(), tmax, [&](int first, int count, float t0, float t1) {
+        return hitLeaf(lanes, first, count, t0, t1) >= 0;
+    });
+}
+
+void SphereSet::hitPacket(RayPacket &packet, float tmin, HitRecord recs[], bool hits[]) const {
+    int best[RayPacket::SIZE];
+    for (int lane = 0; lane < RayPacket::SIZE; lane++) best[lane] = -1;
+
+    bvh.traversePacketLeaves(packet, tmin, [&](int first, int count, int lane, float t0, float &t1) {
+        int s = hitLeaf(RayLanes(packet.rays[lane]), first, count, t0, t1);
+        if (s >= 0) best[lane] = s;
+    });
+
+    for (int lane = 0; lane < RayPacket::SIZE; lane++) {
+        if (best[lane] < 0) continue;
+        recs[lane].t = packet.tmax[lane];
+        recs[lane].object = this;
+        recs[lane].primId = best[lane];
+        hits[lane] = true;
+    }
+}
+
+void SphereSet::occludedPacket(RayPacket &packet, float tmin) const {
+    bvh.traversePacketLeaves(packet, tmin, [&](int first, int count, int lane, float t0, float &t1) {
+        float t = t1;
+        if (hitLeaf(RayLanes(packet.rays[lane]), first, count, t0, t) >= 0)
+            t1 = -std::numeric_limits<float>::infinity();
+    });
+}
+
+void SphereSet::finalize(const Ray &r, const HitRecord &rec, HitInfo &info) const {
+    int sphere = rec.primId;
+    vec3 center(cx[sphere], cy[sphere], cz[sphere]);
+    info.t = rec.t;
+    info.p = r.pointAtParameter(info.t);
+    info.normal = (info.p - center) / radius[sphere];
+    info.mat_ptr = materials.get(materialIndex[sphere]);
+}
+
+void SphereSet::aplicaTG(shared_ptr<TG> t) {
+    // Com Sphere::aplicaTG, només es fan les translacions
+    if (!dynamic_pointer_cast<TranslateTG>(t)) return;
+    for (int i = 0; i < size(); i++) {
+        vec4 c = t->getTG() * vec4(cx[i], cy[i], cz[i], 1.0);
+        cx[i] = c.x; cy[i] = c.y; cz[i] = c.z;
+    }
+    build();
+}
+
+bool SphereSet::boundingBox(AABB &box) const {
+    box = bvh.getBounds();
+    return !bvh.isEmpty();
+}
+
+void SphereSet::print(int indentation) const
+{
+    const QString indent(indentation * 2, ' ');
+    QTextStream(stdout) << indent << "spheres:\t" << size() << "\n";
+    QTextStream(stdout) << indent << "materials:\t" << materials.size() << "\n";
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include "Object.hh"
+#include "Sphere.hh"
+#include "Model/Modelling/BVH.hh"
+#include "Model/Modelling/Simd.hh"
+#include "Model/Modelling/Materials/MaterialTable.hh"
+
+using namespace std;
+
+// Conjunt d'esferes guardades per components (structure of arrays) amb un BVH
+// propi de fulles de LEAF_SIZE esferes. Cada fulla es prova amb unes poques
+// instruccions SIMD per a totes les esferes alhora, en lloc d'una crida virtual
+// a Sphere::intersect per esfera.
+// Els càlculs són els mateixos que els de Sphere i en el mateix ordre: la
+// interseccio trobada és bit a bit la mateixa que la de provar les esferes una a
+// una.
+// L'escena hi agrupa les esferes en construir el seu BVH.
+class SphereSet : public Object
+{
+public:
+    SphereSet() {};
+    virtual ~SphereSet() {};
+
+    void clear();
+
+    // Afegeix una còpia de l'esfera (centre, radi i material). Cal cridar build()
+    // després d'afegir-les totes
+    void add(const Sphere &sphere, shared_ptr<Material> material);
+
+    // Reordena les esferes segons les fulles i construeix el BVH
+    void build();
+
+    int size() const { return (int)radius.size(); }
+
+    // La primitiva és l'índex de l'esfera dins del conjunt
+    virtual bool intersect(const Ray &r, float tmin, float tmax, HitRecord &rec) const override;
+    virtual void finalize(const Ray &r, const HitRecord &rec, HitInfo &info) const override;
+    virtual bool occluded(Ray &r, float tmax) const override;
+
+    // intersect() per a tots els rajos actius del paquet, recorrent el BVH amb el
+    // paquet sencer. Només modifica recs[lane] (amb object = aquest conjunt) i
+    // hits[lane] dels rajos que troben una esfera més propera que packet.tmax[lane],
+    // i en aquest cas actualitza tmax
+    void hitPacket(RayPacket &packet, float tmin, HitRecord recs[], bool hits[]) const;
+
+    // occluded() per a tots els rajos actius del paquet. Els rajos tapats per alguna
+    // esfera queden amb packet.tmax[lane] = -inf
+    void occludedPacket(RayPacket &packet, float tmin) const;
+    virtual void aplicaTG(shared_ptr<TG> tg) override;
+    virtual bool boundingBox(AABB &box) const override;
+
+    virtual void print(int indentation) const override;
+
+    static const int LEAF_SIZE = 8;
+
+private:
+    // Centres, radis i radis al quadrat. Tenen SimdFloat::SIZE posicions de més
+    // perquè la darrera fulla es pugui carregar sencera
+    vector<float> cx, cy, cz;
+    vector<float> radius, radius2;
+    // Material de cada esfera com a índex a materials
+    vector<int>   materialIndex;
+    MaterialTable materials;
+
+    BVH bvh;
+
+    // Components del raig repetides a tots els lanes, calculades un cop per raig
+    struct RayLanes
+    {
+        SimdFloat ox, oy, oz;
+        SimdFloat dx, dy, dz;
+        SimdFloat a;
+        explicit RayLanes(const Ray &r);
+    };
+
+    // Esfera més propera de les esferes [first, first+count) dins de (tmin, tmax).
+    // Retorna -1 si no n'hi ha cap i, si n'hi ha, deixa la t a tmax
+    int hitLeaf(const RayLanes &r, int first, int count, float tmin, float &tmax) const;
+};
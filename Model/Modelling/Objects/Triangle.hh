@@ -12,18 +12,25 @@ public:
 
     virtual ~Triangle() {}
 
-    virtual bool hit(Ray& r, float tmin, float tmax, HitInfo& info) const override;
+    virtual bool intersect(const Ray &r, float tmin, float tmax, HitRecord &rec) const override;
+    virtual void finalize(const Ray &r, const HitRecord &rec, HitInfo &info) const override;
+
+    // Interseccio amb el triangle de vèrtexs vertex1, vertex2 i vertex3, sense
+    // objecte. La fan servir intersect(), les malles i el PrimitiveStore de l'escena
+    static bool intersectVertices(const vec3 &vertex1, const vec3 &vertex2, const vec3 &vertex3,
+                                  const Ray &r, float tmin, float tmax, HitRecord &rec);
 
     virtual void aplicaTG(shared_ptr<TG> tg) override;
+    virtual bool boundingBox(AABB &box) const override;
 
     virtual void read (const QJsonObject &json) override;
     virtual void write(QJsonObject &json) const override;
     virtual void print(int indentation) const override;
 
 
-    vec3  getVertex1() { return vertex1;};
-    vec3  getVertex2() { return vertex2;};
-    vec3  getVertex3() { return vertex3;};
+    vec3  getVertex1() const { return vertex1;};
+    vec3  getVertex2() const { return vertex2;};
+    vec3  getVertex3() const { return vertex3;};
 
 private:
     // Vertice 1 del triangulo
@@ -32,4 +39,67 @@ private:
     vec3 vertex2;
     // Vertice 3 del triangulo
     vec3 vertex3;
+
+    // Normal unitària precalculada per a finalize(). Cal tornar-la a calcular
+    // (precompute) cada cop que canvien els vertexs.
+    // No es guarden les arestes: el test estanc treballa amb els vèrtexs, que són
+    // els mateixos bit a bit als triangles veïns (vertex1 + edge1 no ho seria)
+    vec3 normal;
+
+    void precompute();
 };
+
+
+// Test de triangles estanc (Woop, Benthin i Wald, "Watertight Ray/Triangle
+// Intersection", JCGT 2013). Els vèrtexs es porten a l'espai del raig (origen al
+// raig, direcció (0, 0, 1)) amb la permutació i el cisallament que el raig té
+// precalculats, i el test es fa amb les tres funcions d'aresta 2D U, V i W.
+// Dos triangles que comparteixen una aresta calculen la funció d'aresta amb els
+// mateixos vèrtexs i les mateixes operacions (amb el signe canviat), de manera que
+// un raig no pot passar entre tots dos. Quan alguna funció d'aresta dona
+// exactament 0 es torna a calcular en doble precisió per decidir-ne el signe.
+// Les coordenades baricentriques (u, v) són els pesos de vertex2 i vertex3.
+inline bool Triangle::intersectVertices(const vec3 &vertex1, const vec3 &vertex2, const vec3 &vertex3,
+                                        const Ray &raig, float tmin, float tmax, HitRecord &rec) {
+    int kx = raig.getShearAxis(0);
+    int ky = raig.getShearAxis(1);
+    int kz = raig.getShearAxis(2);
+    const vec3 &S = raig.getShear();
+
+    const vec3 A = vertex1 - raig.getOrigin();
+    const vec3 B = vertex2 - raig.getOrigin();
+    const vec3 C = vertex3 - raig.getOrigin();
+
+    const float Ax = A[kx] - S.x*A[kz];
+    const float Ay = A[ky] - S.y*A[kz];
+    const float Bx = B[kx] - S.x*B[kz];
+    const float By = B[ky] - S.y*B[kz];
+    const float Cx = C[kx] - S.x*C[kz];
+    const float Cy = C[ky] - S.y*C[kz];
+
+    float U = Cx*By - Cy*Bx;
+    float V = Ax*Cy - Ay*Cx;
+    float W = Bx*Ay - By*Ax;
+    if (U == 0.0f || V == 0.0f || W == 0.0f) {
+        U = (float)((double)Cx*(double)By - (double)Cy*(double)Bx);
+        V = (float)((double)Ax*(double)Cy - (double)Ay*(double)Cx);
+        W = (float)((double)Bx*(double)Ay - (double)By*(double)Ax);
+    }
+
+    // El punt ha de ser al mateix costat de les tres arestes (qualsevol costat:
+    // els triangles no tenen cara posterior)
+    if ((U < 0.0f || V < 0.0f || W < 0.0f) && (U > 0.0f || V > 0.0f || W > 0.0f)) return false;
+
+    // Raig paral·lel al pla del triangle (o triangle degenerat)
+    float det = U + V + W;
+    if (det == 0.0f) return false;
+
+    const float T = U*S.z*A[kz] + V*S.z*B[kz] + W*S.z*C[kz];
+    float invDet = 1.0f / det;
+    float t = T * invDet;
+    if (t <= tmin || t >= tmax) return false;
+
+    rec.t = t;
+    rec.bary = vec2(V * invDet, W * invDet);
+    return true;
+}
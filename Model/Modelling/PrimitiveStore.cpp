@@ -0,0 +1,126 @@
+#include <typeinfo>
+#include "PrimitiveStore.hh"
+
+void PrimitiveStore::clear() {
+    refs.clear();
+    boxes.clear();
+    triangles.clear();
+    cylinders.clear();
+    objects.clear();
+    triangleNormals.clear();
+    boxMaterials.clear();
+    triangleMaterials.clear();
+    cylinderMaterials.clear();
+    materials.clear();
+}
+
+bool PrimitiveStore::add(Object *object, AABB &box) {
+    if (!object->boundingBox(box)) return false;
+
+    const type_info &type = typeid(*object);
+    if (type == typeid(Box)) {
+        Box *b = static_cast<Box*>(object);
+        BoxData data;
+        data.vMin = b->getVertexMin();
+        data.vMax = b->getVertexMax();
+        refs.push_back(makeRef(BOX, (int)boxes.size()));
+        boxes.push_back(data);
+        boxMaterials.push_back(materials.id(b->getMaterial()));
+    } else if (type == typeid(Triangle)) {
+        Triangle *tr = static_cast<Triangle*>(object);
+        TriangleData data;
+        data.vertex1 = tr->getVertex1();
+        data.vertex2 = tr->getVertex2();
+        data.vertex3 = tr->getVertex3();
+        refs.push_back(makeRef(TRIANGLE, (int)triangles.size()));
+        triangles.push_back(data);
+        // Mateix càlcul que Triangle::precompute()
+        triangleNormals.push_back(normalize(cross(data.vertex2 - data.vertex1, data.vertex3 - data.vertex1)));
+        triangleMaterials.push_back(materials.id(tr->getMaterial()));
+    } else if (type == typeid(Cylinder)) {
+        Cylinder *c = static_cast<Cylinder*>(object);
+        CylinderData data;
+        data.center = c->getCenter();
+        data.radius = c->getRadius();
+        data.height = c->getHeight();
+        refs.push_back(makeRef(CYLINDER, (int)cylinders.size()));
+        cylinders.push_back(data);
+        cylinderMaterials.push_back(materials.id(c->getMaterial()));
+    } else {
+        refs.push_back(makeRef(OBJECT, (int)objects.size()));
+        objects.push_back(object);
+    }
+    return true;
+}
+
+void PrimitiveStore::reorder(const vector<int> &order) {
+    // Només es mouen les referències: cada vector de tipus queda en l'ordre de les
+    // seves primitives dins del nou ordre
+    vector<int> oldRefs(refs);
+    vector<BoxData>      oldBoxes(boxes);
+    vector<TriangleData> oldTriangles(triangles);
+    vector<CylinderData> oldCylinders(cylinders);
+    vector<Object*>      oldObjects(objects);
+    vector<vec3>         oldNormals(triangleNormals);
+    vector<int> oldBoxMaterials(boxMaterials), oldTriangleMaterials(triangleMaterials),
+                oldCylinderMaterials(cylinderMaterials);
+
+    boxes.clear(); triangles.clear(); cylinders.clear(); objects.clear();
+    triangleNormals.clear();
+    boxMaterials.clear(); triangleMaterials.clear(); cylinderMaterials.clear();
+
+    for (unsigned int i = 0; i < order.size(); i++) {
+        int ref = oldRefs[order[i]];
+        int index = ref >> 2;
+        switch (ref & 3) {
+        case BOX:
+            refs[i] = makeRef(BOX, (int)boxes.size());
+            boxes.push_back(oldBoxes[index]);
+            boxMaterials.push_back(oldBoxMaterials[index]);
+            break;
+        case TRIANGLE:
+            refs[i] = makeRef(TRIANGLE, (int)triangles.size());
+            triangles.push_back(oldTriangles[index]);
+            triangleNormals.push_back(oldNormals[index]);
+            triangleMaterials.push_back(oldTriangleMaterials[index]);
+            break;
+        case CYLINDER:
+            refs[i] = makeRef(CYLINDER, (int)cylinders.size());
+            cylinders.push_back(oldCylinders[index]);
+            cylinderMaterials.push_back(oldCylinderMaterials[index]);
+            break;
+        default:
+            refs[i] = makeRef(OBJECT, (int)objects.size());
+            objects.push_back(oldObjects[index]);
+        }
+    }
+}
+
+void PrimitiveStore::finalize(int prim, const Ray &r, const HitRecord &rec, HitInfo &info) const {
+    int ref = refs[prim];
+    int index = ref >> 2;
+    switch (ref & 3) {
+    case BOX:
+        info.t = rec.t;
+        info.p = r.pointAtParameter(rec.t);
+        info.mat_ptr = materials.get(boxMaterials[index]);
+        info.normal = Box::entryNormal(r, rec.primId);
+        break;
+    case TRIANGLE:
+        info.t = rec.t;
+        info.p = r.pointAtParameter(rec.t);
+        info.normal = triangleNormals[index];
+        info.bary = rec.bary;
+        info.mat_ptr = materials.get(triangleMaterials[index]);
+        break;
+    case CYLINDER:
+        info.t = rec.t;
+        info.p = r.pointAtParameter(info.t);
+        info.mat_ptr = materials.get(cylinderMaterials[index]);
+        info.normal = Cylinder::surfaceNormal(cylinders[index].center, cylinders[index].radius,
+                                              info.p, rec.primId);
+        break;
+    default:
+        objects[index]->finalize(r, rec, info);
+    }
+}
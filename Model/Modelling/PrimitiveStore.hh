@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vector>
+
+#include "Hitable.hh"
+#include "AABB.hh"
+#include "Objects/Object.hh"
+#include "Objects/Box.hh"
+#include "Objects/Triangle.hh"
+#include "Objects/Cylinder.hh"
+#include "Materials/MaterialTable.hh"
+
+using namespace std;
+
+// Versió compilada per al render dels objectes afitats de l'escena. Les capses, els
+// triangles i els cilindres es copien en vectors contigus per tipus amb només la
+// geometria que fa servir la interseccio, i el material de cada primitiva és un
+// índex a una taula de materials. Durant el recorregut no es toquen els objectes
+// (noms, animacions, taules virtuals): només aquests vectors.
+// Els objectes d'altres tipus (malles, esferes soltes) es guarden com a punter i
+// es proven amb les seves funcions virtuals.
+// La representació editable de l'escena (Scene::objects) no canvia: l'escena torna
+// a compilar el magatzem cada cop que construeix el BVH.
+class PrimitiveStore
+{
+public:
+    PrimitiveStore() {};
+
+    void clear();
+
+    // Afegeix una primitiva per a l'objecte i en deixa la capsa contenidora a box.
+    // Retorna fals, sense afegir res, si l'objecte no és afitat
+    bool add(Object *object, AABB &box);
+
+    // Reordena les primitives: la nova primitiva i és l'antiga order[i]. L'escena
+    // hi passa l'ordre de les fulles del BVH perquè cada fulla llegeixi posicions
+    // seguides
+    void reorder(const vector<int> &order);
+
+    int size() const { return (int)refs.size(); }
+
+    // Com Object::intersect() per a la primitiva prim. Per a les primitives que
+    // són objectes, deixa també rec.object
+    bool intersect(int prim, const Ray &r, float tmin, float tmax, HitRecord &rec) const;
+
+    // Com Object::occluded() per a la primitiva prim
+    bool occluded(int prim, Ray &r, float tmax) const;
+
+    // Com Object::finalize() per a la primitiva prim trobada per intersect()
+    void finalize(int prim, const Ray &r, const HitRecord &rec, HitInfo &info) const;
+
+private:
+    typedef enum
+    {
+        BOX,
+        TRIANGLE,
+        CYLINDER,
+        OBJECT
+    } PRIMITIVE_TYPES;
+
+    // Cada primitiva és un enter: el tipus als dos bits baixos i l'índex dins del
+    // vector del seu tipus a la resta
+    vector<int> refs;
+
+    static int makeRef(int type, int index) { return (index << 2) | type; }
+
+    struct BoxData
+    {
+        vec3 vMin, vMax;
+    };
+
+    struct TriangleData
+    {
+        vec3 vertex1, vertex2, vertex3;
+    };
+
+    struct CylinderData
+    {
+        vec3  center;
+        float radius, height;
+    };
+
+    // Geometria que es llegeix durant el recorregut
+    vector<BoxData>      boxes;
+    vector<TriangleData> triangles;
+    vector<CylinderData> cylinders;
+    vector<Object*>      objects;
+
+    // Dades que només fa servir finalize()
+    vector<vec3> triangleNormals;
+    vector<int>  boxMaterials, triangleMaterials, cylinderMaterials;
+    MaterialTable materials;
+};
+
+
+inline bool PrimitiveStore::intersect(int prim, const Ray &r, float tmin, float tmax, HitRecord &rec) const {
+    int ref = refs[prim];
+    int index = ref >> 2;
+    switch (ref & 3) {
+    case BOX:
+        return Box::intersectSlabs(boxes[index].vMin, boxes[index].vMax, r, tmin, tmax, rec);
+    case TRIANGLE:
+        return Triangle::intersectVertices(triangles[index].vertex1, triangles[index].vertex2,
+                                           triangles[index].vertex3, r, tmin, tmax, rec);
+    case CYLINDER:
+        return Cylinder::intersectVertical(cylinders[index].center, cylinders[index].radius,
+                                           cylinders[index].height, r, tmin, tmax, rec);
+    default:
+        if (!objects[index]->intersect(r, tmin, tmax, rec)) return false;
+        rec.object = objects[index];
+        return true;
+    }
+}
+
+inline bool PrimitiveStore::occluded(int prim, Ray &r, float tmax) const {
+    int ref = refs[prim];
+    if ((ref & 3) == OBJECT) return objects[ref >> 2]->occluded(r, tmax);
+    HitRecord rec;
+    return intersect(prim, r, r.getTmin(), tmax, rec);
+}
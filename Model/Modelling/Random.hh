@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+// Generador de nombres aleatoris PCG32 (O'Neill, pcg-random.org). És petit, ràpid
+// i, a diferència de rand(), no comparteix estat entre threads: cada thread fa
+// servir el seu propi generador (local()). El RayTracer el torna a inicialitzar a
+// cada pixel a partir de (x, y, seed), de manera que la imatge no depèn de com
+// s'hagin repartit els tiles entre threads.
+class Random
+{
+public:
+    Random(uint64_t seed = 0, uint64_t stream = 0) { setSeed(seed, stream); }
+
+    // stream: seqüència independent (per exemple l'índex del pixel)
+    void setSeed(uint64_t seed, uint64_t stream) {
+        state = 0u;
+        inc = (stream << 1u) | 1u;
+        next();
+        state += seed;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = (uint32_t)(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+    }
+
+    // Real uniforme a [0, 1)
+    float nextFloat() {
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Generador del thread actual
+    static Random &local() {
+        static thread_local Random rng;
+        return rng;
+    }
+
+private:
+    uint64_t state;
+    uint64_t inc;
+};
@@ -1,4 +1,6 @@
 #pragma once
+#include <limits>
+#include <utility>
 #include "glm/glm.hpp"
 
 
@@ -8,14 +10,44 @@ class Ray {
   private:
     vec3 origin;
     vec3 direction;
+    // 1/direction i signe de cada component de la direcció (1 si és negativa),
+    // calculats un cop en crear el raig per als tests de capses (slabs)
+    vec3 invDirection;
+    int  sign[3];
+    // Transformació del test de triangles estanc: eixos permutats perquè la
+    // component més gran de la direcció sigui la z, i coeficients del cisallament
+    // que porta la direcció a (0, 0, 1)
+    int  shearAxis[3];
+    vec3 shear;
+    // Interval [tmin, tmax] del raig on es busquen les interseccions
+    float tmin;
+    float tmax;
 
   public:
     Ray() {}
 
     Ray(const vec3 &orig, const vec3 &dir, float t_min_=0.01f, float t_max_=std::numeric_limits<float>::infinity()):
       origin(orig),
-      direction(dir)
-    {}
+      direction(dir),
+      invDirection(1.0f / dir),
+      tmin(t_min_),
+      tmax(t_max_)
+    {
+      sign[0] = invDirection.x < 0.0f;
+      sign[1] = invDirection.y < 0.0f;
+      sign[2] = invDirection.z < 0.0f;
+
+      vec3 a = abs(dir);
+      int kz = (a.x > a.y) ? (a.x > a.z ? 0 : 2) : (a.y > a.z ? 1 : 2);
+      int kx = (kz + 1) % 3;
+      int ky = (kx + 1) % 3;
+      // Es conserva l'orientació dels triangles
+      if (dir[kz] < 0.0f) std::swap(kx, ky);
+      shearAxis[0] = kx;
+      shearAxis[1] = ky;
+      shearAxis[2] = kz;
+      shear = vec3(dir[kx] * invDirection[kz], dir[ky] * invDirection[kz], invDirection[kz]);
+    }
 
     /* retorna el punt del raig en en temps/lambda t */
     vec3 operator() (const float &t) const {
@@ -24,6 +56,12 @@ class Ray {
 
     vec3 getOrigin() const       { return origin; }
     vec3 getDirection() const    { return direction; }
+    const vec3 &getInvDirection() const { return invDirection; }
+    int  getSign(int axis) const { return sign[axis]; }
+    int  getShearAxis(int i) const { return shearAxis[i]; }
+    const vec3 &getShear() const { return shear; }
+    float getTmin() const        { return tmin; }
+    float getTmax() const        { return tmax; }
     vec3 pointAtParameter(float t) const { return origin + t*direction; }
 
 };
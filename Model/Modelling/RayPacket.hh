@@ -0,0 +1,98 @@
+#pragma once
+
+#include <limits>
+#include "Ray.hh"
+#include "AABB.hh"
+#include "Simd.hh"
+
+// Paquet de rajos (normalment de pixels veïns) que es recorren junts pel BVH.
+// Els orígens i les inverses de les direccions es guarden per components
+// (structure of arrays) per poder provar una capsa contra tots els rajos amb
+// unes poques instruccions SIMD. Els lanes que no es fan servir queden fora de
+// activeMask.
+struct RayPacket
+{
+    static const int SIZE = SimdFloat::SIZE;
+
+    Ray       rays[SIZE];
+    float     tmax[SIZE];
+    int       activeMask;
+
+    SimdFloat ox, oy, oz;
+    SimdFloat invDx, invDy, invDz;
+
+    RayPacket() { reset(); }
+
+    // Deixa tots els lanes buits per tornar a omplir el paquet. Els rajos i les
+    // components SoA dels lanes inactius no es fan servir i no cal esborrar-los
+    void reset() {
+        activeMask = 0;
+        for (int i = 0; i < SIZE; i++) tmax[i] = -std::numeric_limits<float>::infinity();
+    }
+
+    // Posa el raig r al lane i. S'ha de cridar per a tots els lanes abans de finish()
+    void set(int i, const Ray &r) {
+        rays[i] = r;
+        tmax[i] = r.getTmax();
+        activeMask |= 1 << i;
+    }
+
+    // Prepara les components SoA dels lanes actius. Els lanes buits tenen tmax = -inf,
+    // de manera que mai tallen cap capsa
+    void finish() {
+        float o[3][SIZE], inv[3][SIZE];
+        for (int i = 0; i < SIZE; i++) {
+            vec3 orig = rays[i].getOrigin();
+            vec3 d = rays[i].getInvDirection();
+            if (!(activeMask & (1 << i))) {
+                orig = vec3(0.0f);
+                d = vec3(1.0f);
+            }
+            for (int k = 0; k < 3; k++) {
+                o[k][i] = orig[k];
+                inv[k][i] = d[k];
+            }
+        }
+        ox = SimdFloat::load(o[0]); oy = SimdFloat::load(o[1]); oz = SimdFloat::load(o[2]);
+        invDx = SimdFloat::load(inv[0]); invDy = SimdFloat::load(inv[1]); invDz = SimdFloat::load(inv[2]);
+    }
+
+    // Cert si les direccions dels rajos actius queden dins d'un con estret: l'angle
+    // amb la del primer raig actiu té el cosinus com a mínim COHERENT_COS. Si els
+    // rajos divergeixen (desenfocament, rebots, vores disperses) cada lane baixa per
+    // nodes diferents i el paquet és més lent que traçar-los un a un
+    bool isCoherent() const {
+        bool first = true;
+        vec3 d0;
+        for (int i = 0; i < SIZE; i++) {
+            if (!(activeMask & (1 << i))) continue;
+            vec3 d = normalize(rays[i].getDirection());
+            if (first) {
+                d0 = d;
+                first = false;
+            } else if (dot(d, d0) < COHERENT_COS)
+                return false;
+        }
+        return true;
+    }
+
+    static constexpr float COHERENT_COS = 0.995f;
+
+    // Test de les slabs de la capsa amb tots els rajos alhora. Retorna la màscara
+    // dels rajos que la tallen dins de [tmin, tmax[i]] i deixa a tEnter la t d'entrada
+    int intersect(const AABB &box, float tmin, float tEnter[SIZE]) const {
+        SimdFloat t0x = (SimdFloat(box.pmin.x) - ox) * invDx;
+        SimdFloat t1x = (SimdFloat(box.pmax.x) - ox) * invDx;
+        SimdFloat t0y = (SimdFloat(box.pmin.y) - oy) * invDy;
+        SimdFloat t1y = (SimdFloat(box.pmax.y) - oy) * invDy;
+        SimdFloat t0z = (SimdFloat(box.pmin.z) - oz) * invDz;
+        SimdFloat t1z = (SimdFloat(box.pmax.z) - oz) * invDz;
+
+        SimdFloat tnear = simdMax(simdMax(simdMin(t0x, t1x), simdMin(t0y, t1y)),
+                                  simdMax(simdMin(t0z, t1z), SimdFloat(tmin)));
+        SimdFloat tfar = simdMin(simdMin(simdMax(t0x, t1x), simdMax(t0y, t1y)),
+                                 simdMin(simdMax(t0z, t1z), SimdFloat::load(tmax)));
+        tnear.store(tEnter);
+        return lessEqualMask(tnear, tfar) & activeMask;
+    }
+};
@@ -1,3 +1,4 @@
+#include <typeinfo>
 #include "Scene.hh"
 
 Scene::Scene()
@@ -7,6 +8,11 @@ Scene::Scene()
 }
 
 
+unsigned long long &Scene::tracedRays() {
+    static thread_local unsigned long long count = 0;
+    return count;
+}
+
 bool Scene::hit(Ray &raig, float tmin, float tmax, HitInfo& info) const {
     // TODO FASE 0 i FASE 1:
     // Heu de codificar la vostra solucio per aquest metode substituint el 'return true'
@@ -16,27 +22,211 @@ bool Scene::hit(Ray &raig, float tmin, float tmax, HitInfo& info) const {
     // la informació sobre la interseccio.
     // Cada vegada que s'intersecta un objecte s'ha d'actualitzar el HitInfo del raig.
 
+    tracedRays()++;
+
+    // Durant el recorregut només es guarda la t i la primitiva de cada candidat
+    // (HitRecord); el HitInfo es calcula al final per a l'objecte més proper
+    HitRecord rec;
     float t = tmax;
-    // Loops through every object
-    for (unsigned int i = 0; i < objects.size(); i++) {
-        // If the ray hits the object
-        if (objects[i]->hit(raig, tmin, t, info)) {
-            // If the hit occurs closer than 't'
-            if(info.t < t) {
-                t = info.t;
+    int prim = -1;
+    if (!bvhBuilt) {
+        // Loops through every object
+        for (unsigned int i = 0; i < objects.size(); i++) {
+            // If the ray hits the object closer than 't'
+            if (objects[i]->intersect(raig, tmin, t, rec)) {
+                t = rec.t;
+                rec.object = objects[i].get();
+            }
+        }
+    } else {
+        bvh.traverse(raig, tmin, t, [&](int i, float t0, float &t1) {
+            if (primitives.intersect(i, raig, t0, t1, rec)) {
+                t1 = rec.t;
+                prim = i;
+                return true;
+            }
+            return false;
+        });
+
+        if (sphereSet.size() > 0 && sphereSet.intersect(raig, tmin, t, rec)) {
+            t = rec.t;
+            rec.object = &sphereSet;
+            prim = -1;
+        }
+
+        for (unsigned int i = 0; i < unboundedObjects.size(); i++) {
+            if (unboundedObjects[i]->intersect(raig, tmin, t, rec)) {
+                t = rec.t;
+                rec.object = unboundedObjects[i];
+                prim = -1;
             }
         }
     }
 
-    if (t == tmax) return false;
+    if (prim >= 0) {
+        primitives.finalize(prim, raig, rec, info);
+        return true;
+    }
+    if (rec.object == nullptr) return false;
+    rec.object->finalize(raig, rec, info);
     return true;
 }
 
 
+bool Scene::occluded(Ray &raig, float tmax) const {
+    tracedRays()++;
+
+    if (!bvhBuilt) {
+        for (unsigned int i = 0; i < objects.size(); i++)
+            if (objects[i]->occluded(raig, tmax)) return true;
+        return false;
+    }
+
+    if (bvh.any(raig, raig.getTmin(), tmax, [&](int i, float, float t1) {
+            return primitives.occluded(i, raig, t1);
+        }))
+        return true;
+
+    if (sphereSet.size() > 0 && sphereSet.occluded(raig, tmax))
+        return true;
+
+    for (unsigned int i = 0; i < unboundedObjects.size(); i++)
+        if (unboundedObjects[i]->occluded(raig, tmax)) return true;
+    return false;
+}
+
+
+void Scene::hitPacket(RayPacket &packet, float tmin, HitInfo infos[], bool hits[]) const {
+    for (int lane = 0; lane < RayPacket::SIZE; lane++) hits[lane] = false;
+
+    // Els paquets divergents es tracen raig a raig
+    if (!bvhBuilt || !packet.isCoherent()) {
+        for (int lane = 0; lane < RayPacket::SIZE; lane++) {
+            if (packet.activeMask & (1 << lane))
+                hits[lane] = hit(packet.rays[lane], tmin, packet.tmax[lane], infos[lane]);
+        }
+        return;
+    }
+
+    HitRecord recs[RayPacket::SIZE];
+    int prims[RayPacket::SIZE];
+    bvh.traversePacket(packet, tmin, [&](int i, int lane, float t0, float &t1) {
+        if (primitives.intersect(i, packet.rays[lane], t0, t1, recs[lane])) {
+            t1 = recs[lane].t;
+            prims[lane] = i;
+            hits[lane] = true;
+        }
+    });
+
+    // Els conjunts d'esferes i els objectes no afitats deixen l'objecte a recs[lane]:
+    // si en troben un de més proper, la primitiva del BVH ja no és la guanyadora
+    for (int lane = 0; lane < RayPacket::SIZE; lane++) recs[lane].object = nullptr;
+    if (sphereSet.size() > 0)
+        sphereSet.hitPacket(packet, tmin, recs, hits);
+
+    for (int lane = 0; lane < RayPacket::SIZE; lane++) {
+        if (!(packet.activeMask & (1 << lane))) continue;
+        tracedRays()++;
+        for (unsigned int i = 0; i < unboundedObjects.size(); i++) {
+            if (unboundedObjects[i]->intersect(packet.rays[lane], tmin, packet.tmax[lane], recs[lane])) {
+                packet.tmax[lane] = recs[lane].t;
+                recs[lane].object = unboundedObjects[i];
+                hits[lane] = true;
+            }
+        }
+        if (!hits[lane]) continue;
+        if (recs[lane].object != nullptr)
+            recs[lane].object->finalize(packet.rays[lane], recs[lane], infos[lane]);
+        else
+            primitives.finalize(prims[lane], packet.rays[lane], recs[lane], infos[lane]);
+    }
+}
+
+
+void Scene::occludedPacket(RayPacket &packet, float tmin, bool blocked[]) const {
+    const float tBlocked = -std::numeric_limits<float>::infinity();
+    if (!bvhBuilt || !packet.isCoherent()) {
+        for (int lane = 0; lane < RayPacket::SIZE; lane++)
+            blocked[lane] = (packet.activeMask & (1 << lane)) && occluded(packet.rays[lane], packet.tmax[lane]);
+        return;
+    }
+
+    for (int lane = 0; lane < RayPacket::SIZE; lane++) {
+        blocked[lane] = false;
+        if (packet.activeMask & (1 << lane)) tracedRays()++;
+    }
+
+    // Quan un raig queda tapat se li posa tmax = -inf: a partir d'aquí no talla cap
+    // capsa i el paquet continua només amb els altres
+    bvh.traversePacketLeaves(packet, tmin, [&](int first, int count, int lane, float, float &t1) {
+        for (int i = first; i < first + count; i++) {
+            if (primitives.occluded(i, packet.rays[lane], t1)) {
+                t1 = tBlocked;
+                return;
+            }
+        }
+    });
+
+    if (sphereSet.size() > 0)
+        sphereSet.occludedPacket(packet, tmin);
+
+    for (int lane = 0; lane < RayPacket::SIZE; lane++) {
+        if (!(packet.activeMask & (1 << lane))) continue;
+        for (unsigned int i = 0; i < unboundedObjects.size() && packet.tmax[lane] != tBlocked; i++) {
+            if (unboundedObjects[i]->occluded(packet.rays[lane], packet.tmax[lane]))
+                packet.tmax[lane] = tBlocked;
+        }
+        blocked[lane] = packet.tmax[lane] == tBlocked;
+    }
+}
+
+
+void Scene::buildBVH() {
+    primitives.clear();
+    unboundedObjects.clear();
+    sphereSet.clear();
+
+    vector<AABB> bounds;
+    bounds.reserve(objects.size());
+    vector<Sphere*> spheres;
+    for (unsigned int i = 0; i < objects.size(); i++) {
+        AABB box;
+        if (typeid(*objects[i]) == typeid(Sphere)) {
+            spheres.push_back(static_cast<Sphere*>(objects[i].get()));
+        } else if (primitives.add(objects[i].get(), box)) {
+            bounds.push_back(box);
+        } else {
+            unboundedObjects.push_back(objects[i].get());
+        }
+    }
+
+    if ((int)spheres.size() >= MIN_SPHERE_SET) {
+        for (unsigned int i = 0; i < spheres.size(); i++)
+            sphereSet.add(*spheres[i], spheres[i]->getMaterial());
+        sphereSet.build();
+    } else {
+        for (unsigned int i = 0; i < spheres.size(); i++) {
+            AABB box;
+            primitives.add(spheres[i], box);
+            bounds.push_back(box);
+        }
+    }
+
+    bvh.build(bounds);
+    // Les primitives de cada fulla queden seguides: la fulla leftFirst..leftFirst+count
+    // indexa directament el magatzem
+    primitives.reorder(bvh.primIndices);
+    for (unsigned int i = 0; i < bvh.primIndices.size(); i++) bvh.primIndices[i] = i;
+    bvhBuilt = true;
+}
+
+
 void Scene::update(int nframe) {
     for (unsigned int i = 0; i< objects.size(); i++) {
         objects[i]->update(nframe);
     }
+    // La geometria ha canviat: cal tornar a construir el BVH
+    bvhBuilt = false;
 }
 
 void Scene::setDimensions(vec3 p1, vec3 p2) {
@@ -3,8 +3,11 @@
 #include <vector>
 #include "Hitable.hh"
 #include "Animation.hh"
+#include "BVH.hh"
+#include "PrimitiveStore.hh"
 #include "Objects/Object.hh"
 #include "Objects/Sphere.hh"
+#include "Objects/SphereSet.hh"
 
 #include "Materials/Material.hh"
 
@@ -53,6 +56,22 @@ public:
     // Retorna cert si existeix la interseccio, fals, en cas contrari
     virtual bool hit(Ray& raig, float tmin, float tmax, HitInfo& info) const override;
 
+    // Cert si algun objecte talla el raig entre raig.getTmin() i tmax. Acaba a la
+    // primera intersecció que troba: és la consulta per als rajos d'ombra
+    virtual bool occluded(Ray &raig, float tmax) const override;
+
+    // Interseccio de tots els rajos actius d'un paquet amb l'escena, recorrent el
+    // BVH un sol cop per a tot el paquet. Per a cada lane, hits[lane] diu si hi ha
+    // interseccio i infos[lane] en conté la informació, com a hit().
+    // Si el paquet no és coherent (RayPacket::isCoherent()) cada raig es traça sol
+    // amb hit()
+    void hitPacket(RayPacket &packet, float tmin, HitInfo infos[], bool hits[]) const;
+
+    // occluded() per a tots els rajos actius d'un paquet (rajos d'ombra). Cada raig
+    // té el seu tmax a packet.tmax. Deixa a blocked[lane] si el raig està tapat.
+    // Com hitPacket(), els paquets no coherents es proven raig a raig
+    void occludedPacket(RayPacket &packet, float tmin, bool blocked[]) const;
+
 
     // OPCIONAL: Mètode que retorna totes les interseccions que es troben al llarg del raig
     //    virtual bool allHits(const Ray& r, vector<shared_ptr<HitInfo> infos) const = 0;
@@ -61,6 +80,19 @@ public:
 
     void setDimensions(vec3 p1, vec3 p2);
 
+    // Construeix el BVH amb els objectes afitats de l'escena. Cal cridar-lo cada
+    // vegada que canvia "objects" o la geometria dels objectes (animacions) abans de
+    // fer el render. Mentre no s'ha construit, hit() recorre tots els objectes.
+    // Els objectes afitats es compilen en un PrimitiveStore, que és el que recorre
+    // el BVH.
+    // Si hi ha com a mínim MIN_SPHERE_SET esferes, s'agrupen en un SphereSet amb
+    // el seu propi BVH, que es prova a part.
+    void buildBVH();
+
+    // Nombre de crides a hit() fetes pel thread actual. Serveix per comptar els
+    // rajos traçats durant el render sense compartir cap comptador entre threads
+    static unsigned long long &tracedRays();
+
     // TODO FASE 2:
     // Incloure bases a l'escena: FittedPlane
     // void setBasePlane(shared_ptr<FittedPlane> plane);
@@ -68,6 +100,16 @@ public:
     // AMPLIACIO: Posible objecte que no sigui un fitted plane: una esfera
     // void setBaseSphere(shared_ptr<Sphere> sphere);
 
-
+private:
+    // BVH sobre primitives, en l'ordre de les fulles. Els objectes no afitats
+    // (plans) es proven a part
+    BVH             bvh;
+    PrimitiveStore  primitives;
+    vector<Object*> unboundedObjects;
+    bool            bvhBuilt = false;
+    // Esferes de "objects" en format SoA, amb el seu propi BVH
+    SphereSet       sphereSet;
+
+    static const int MIN_SPHERE_SET = 8;
 };
 
@@ -1,3 +1,11 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <QDir>
+#include <QFileInfo>
 #include "SceneFactoryData.hh"
 
 SceneFactoryData::SceneFactoryData(shared_ptr<VisualMapping> mr):SceneFactory()
@@ -8,7 +16,9 @@ SceneFactoryData::SceneFactoryData(shared_ptr<VisualMapping> mr):SceneFactory()
 
 shared_ptr<Scene> SceneFactoryData::createScene(QString nameFile) {
     scene = make_shared<Scene>();
-    load(nameFile);
+    // Els materials no es comparteixen entre escenes
+    materials.clear();
+    if (!load(nameFile)) return nullptr;
     print(0);
     return visualMaps();
 }
@@ -31,6 +41,7 @@ bool SceneFactoryData::load(QString nameFile)
         qWarning("Couldn't open the data scene file.");
         return false;
     }
+    sceneDir = QFileInfo(nameFile).absolutePath();
 
     QByteArray saveData = loadFile.readAll();
     QJsonParseError error;
@@ -43,6 +54,10 @@ bool SceneFactoryData::load(QString nameFile)
     }
     QJsonObject object = loadDoc.object();
     read(object);
+    if (missingData > 0) {
+        qWarning("%d attributes of the data scene have no data.", missingData);
+        return false;
+    }
 
     QTextStream(stdout) << "Loaded data scene" << "...\n";
     return true;
@@ -92,12 +107,19 @@ void SceneFactoryData::read(const QJsonObject &json)
 
     mapping = make_shared<VisualMapping>();
     mapping->read(json);
+    missingData = 0;
     if (json.contains("attributes") && json["attributes"].isArray()) {
       QJsonArray attributeMappingsArray = json["attributes"].toArray();
       for (int propIndex = 0; propIndex < attributeMappingsArray.size(); propIndex++) {
           QJsonObject propObject = attributeMappingsArray[propIndex].toObject();
           mapping->readAttribute(propObject);
-          readData(propObject);
+          // Un atribut sense dades es treu del mapping: els atributs i les dades
+          // s'aparellen per índex
+          if (!readData(propObject)) {
+              delete mapping->attributeMapping.back();
+              mapping->attributeMapping.pop_back();
+              missingData++;
+          }
       }
     }
 }
@@ -148,6 +170,13 @@ void SceneFactoryData::print(int indentation) const
     QTextStream(stdout) << indent << "Attributes:\t\n";
     for (unsigned int i=0; i<dades.size(); i++) {
         mapping->printAttribute(i, indentation);
+        // D'un fitxer extern només es mostra la referència: pot tenir milions de mostres
+        if (!dataSources[i].fileName.isEmpty()) {
+            QTextStream(stdout) << indent << "dataFile:\t" << dataSources[i].fileName << "\n";
+            QTextStream(stdout) << indent << "format:\t" << DataFileReader::getNameFormat(dataSources[i].format) << "\n";
+            QTextStream(stdout) << indent << "samples:\t" << (unsigned int)dades[i].second.size() << "\n";
+            continue;
+        }
         QTextStream(stdout) << indent << "data:\t\n";
         for (unsigned int j=0; j<dades[i].second.size(); j++) {
                QTextStream(stdout) << indent << "[ "<< dades[i].second[j][0]<< ", "<< dades[i].second[j][1]<< ", "<<dades[i].second[j][2]<< " ]\n ";
@@ -157,12 +186,27 @@ void SceneFactoryData::print(int indentation) const
 
 
 
-void SceneFactoryData::readData(const QJsonObject &json) {
+bool SceneFactoryData::readData(const QJsonObject &json) {
 
     vector<vec3> values;
-
-    if (json.contains("data") && json["data"].isArray()) {
+    DataSource source;
+    source.format = DataFileReader::CSV;
+
+    if (json.contains("dataFile") && json["dataFile"].isString()) {
+        // Les dades són en un fitxer a part: no es passen pel document JSON
+        source.fileName = json["dataFile"].toString();
+        if (json.contains("format") && json["format"].isString())
+            source.format = DataFileReader::getFormat(json["format"].toString().toUpper());
+
+        QString path = source.fileName;
+        if (QDir::isRelativePath(path) && !sceneDir.isEmpty())
+            path = QDir(sceneDir).filePath(path);
+
+        DataFileReader reader;
+        if (!reader.load(path, source.format, values)) return false;
+    } else if (json.contains("data") && json["data"].isArray()) {
         QJsonArray dataArray = json["data"].toArray();
+        values.reserve(dataArray.size());
         for (int dataIndex = 0; dataIndex < dataArray.size(); dataIndex++) {
             QJsonArray value = dataArray[dataIndex].toArray();
             vec3 sample;
@@ -171,15 +215,30 @@ void SceneFactoryData::readData(const QJsonObject &json) {
             sample[2] = value[2].toDouble();
             values.push_back(sample);
         }
-        if (json.contains("name") && json["name"].isString()) {
-            QString name = json["name"].toString().toUpper();
-            dades.push_back(make_pair(name, values));
-        }
+    } else {
+        qWarning("Parse error in json data scene file: attribute without data or dataFile.");
+        return false;
     }
+
+    if (!json.contains("name") || !json["name"].isString()) {
+        qWarning("Parse error in json data scene file: attribute without name.");
+        return false;
+    }
+    QString name = json["name"].toString().toUpper();
+    dades.push_back(make_pair(name, std::move(values)));
+    dataSources.push_back(source);
+    return true;
 }
 
 void SceneFactoryData::writeData (QJsonObject &json, int i) const {
 
+    // Les dades d'un fitxer extern es tornen a referenciar, no es copien al JSON
+    if (!dataSources[i].fileName.isEmpty()) {
+        json["dataFile"] = dataSources[i].fileName;
+        json["format"] = DataFileReader::getNameFormat(dataSources[i].format);
+        return;
+    }
+
     QJsonArray valuesJson;
     for (unsigned int j=0; j<dades[i].second.size(); j++) {
         QJsonArray val;
@@ -195,29 +254,76 @@ void SceneFactoryData::writeData (QJsonObject &json, int i) const {
 // Metode que mapeja les dades llegides a una escena virtual segons la informació del Visual Mapping
 shared_ptr<Scene> SceneFactoryData::visualMaps() {
 
-    // TO DO: A partir de les dades carregades, cal contruir l'escena virtual amb tot colocat al seu lloc
-    // i a la seva mida
+    // Els gizmos de totes les mostres es construeixen en paral·lel. Cada mostra té
+    // reservada la seva posició a scene->objects (atribut a atribut, en l'ordre de
+    // les dades), de manera que l'escena és la mateixa que en seqüencial i els
+    // threads no comparteixen res més que el comptador de blocs
+    buildPaletteMaterials();
 
-    // TO DO: Fase 1: PAS 5. Recorregut de les dades:
+    // Els atributs amb "lod" fan un gizmo per cel·la en lloc d'un per mostra
+    gizmoData.assign(dades.size(), nullptr);
+    lodSamples.assign(dades.size(), vector<vec3>());
+    valueRanges.resize(dades.size());
     for (unsigned int i=0; i< dades.size(); i++) {
-
-        // Per cada valor de l'atribut, cal donar d'alta un objecte (gizmo) a l'escena
-        for (unsigned int j=0; j<dades[i].second.size(); j++) {
-            auto o = objectMaps(i);
-            o->setMaterial(materialMaps(i, j));
-
-             // Afegir objecte a l'escena virtual ja amb el seu material corresponent
-             scene->objects.push_back(o);
-         }
+        AttributeMapping *propinfo = mapping->attributeMapping[i];
+        valueRanges[i] = vec2(propinfo->minValue, propinfo->maxValue);
+        if (propinfo->lod == AttributeMapping::NONE) {
+            gizmoData[i] = &dades[i].second;
+            continue;
+        }
+        aggregateSamples(i, lodSamples[i]);
+        gizmoData[i] = &lodSamples[i];
+        if (propinfo->lod == AttributeMapping::SUM)
+            valueRanges[i] = sampleRange(lodSamples[i], valueRanges[i]);
+        QTextStream(stdout) << "Lod " << dades[i].first << ": " << (unsigned int)dades[i].second.size()
+                            << " samples in " << (unsigned int)lodSamples[i].size() << " gizmos\n";
     }
+
+    vector<size_t> offsets(dades.size() + 1);
+    size_t first = scene->objects.size();
+    offsets[0] = 0;
+    for (unsigned int i=0; i< dades.size(); i++)
+        offsets[i+1] = offsets[i] + gizmoData[i]->size();
+    size_t total = offsets[dades.size()];
+    scene->objects.resize(first + total);
+
+    int numChunks = (int)((total + GIZMO_CHUNK - 1) / GIZMO_CHUNK);
+    atomic<int> nextChunk(0);
+    auto worker = [&]() {
+        int chunk;
+        while ((chunk = nextChunk.fetch_add(1)) < numChunks) {
+            size_t begin = (size_t)chunk * GIZMO_CHUNK;
+            size_t end = std::min(begin + GIZMO_CHUNK, total);
+            // Atribut de la primera mostra del bloc
+            int i = (int)(std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin()) - 1;
+            for (size_t k = begin; k < end; k++) {
+                while (k >= offsets[i+1]) i++;
+                int j = (int)(k - offsets[i]);
+
+                // Per cada valor de l'atribut, cal donar d'alta un objecte (gizmo) a l'escena
+                auto o = objectMaps(i);
+                if (o != nullptr) o->setMaterial(materialMaps(i, j));
+                scene->objects[first + k] = o;
+            }
+        }
+    };
+
+    int numThreads = std::min((int)std::max(thread::hardware_concurrency(), 1u), std::max(numChunks, 1));
+    vector<thread> pool;
+    for (int t = 1; t < numThreads; t++)
+        pool.push_back(thread(worker));
+    // El thread que crida també treballa
+    worker();
+    for (unsigned int t = 0; t < pool.size(); t++)
+        pool[t].join();
+
+    // Els tipus de gizmo que la factoria no sap crear no deixen objecte
+    scene->objects.erase(std::remove(scene->objects.begin() + first, scene->objects.end(), nullptr),
+                         scene->objects.end());
     return scene;
 }
 
 
-
-
-
-
 shared_ptr<Object> SceneFactoryData::objectMaps(int i) {
 
     // Gyzmo és el tipus d'objecte
@@ -240,25 +346,194 @@ shared_ptr<Object> SceneFactoryData::objectMaps(int i) {
     return o;
 }
 
-shared_ptr<Material> SceneFactoryData::materialMaps(int i,  int j) {
+void SceneFactoryData::setFootprint(shared_ptr<Camera> camera) {
+    footprintCamera = camera;
+}
 
+void SceneFactoryData::aggregateSamples(int i, vector<vec3> &out) const {
     AttributeMapping *propinfo = mapping->attributeMapping[i];
+    const vector<vec3> &samples = dades[i].second;
+    out.clear();
+    if (samples.empty()) return;
+
+    float widthR = mapping->Rxmax - mapping->Rxmin;
+    float depthR = mapping->Rzmax - mapping->Rzmin;
+    float binX = widthR / LOD_DEFAULT_BINS;
+    float binZ = depthR / LOD_DEFAULT_BINS;
+    if (propinfo->lodBinSize > 0.0f) {
+        binX = binZ = propinfo->lodBinSize;
+    } else if (footprintCamera != nullptr) {
+        // Mida d'un píxel a la distància del centre del món virtual, passada al món
+        // real amb la mateixa proporció que fa servir objectMaps()
+        vec3 centre(0.5f*(mapping->Vxmin + mapping->Vxmax), mapping->Vymin, 0.5f*(mapping->Vzmin + mapping->Vzmax));
+        float d = length(centre - footprintCamera->getLookFrom());
+        float pixel = 2.0f * d * tan(glm::radians(footprintCamera->getFOV()) / 2.0f)
+                      / std::max(footprintCamera->viewportY, 1);
+        if (pixel > 0.0f) {
+            binX = pixel * widthR / (mapping->Vxmax - mapping->Vxmin);
+            binZ = pixel * depthR / (mapping->Vzmax - mapping->Vzmin);
+        }
+    }
+    // Les cel·les tapen el rectangle sencer; com a molt LOD_MAX_BINS per costat
+    // perquè la cel·la càpiga a la clau
+    int nx = (widthR > 0.0f && binX > 0.0f) ? (int)std::min(std::ceil(widthR / binX), (float)LOD_MAX_BINS) : 1;
+    int nz = (depthR > 0.0f && binZ > 0.0f) ? (int)std::min(std::ceil(depthR / binZ), (float)LOD_MAX_BINS) : 1;
+    nx = std::max(nx, 1);
+    nz = std::max(nz, 1);
+    float cellX = (widthR > 0.0f) ? widthR / nx : 1.0f;
+    float cellZ = (depthR > 0.0f) ? depthR / nz : 1.0f;
+
+    vector<uint32_t> cells(samples.size());
+    for (size_t j = 0; j < samples.size(); j++) {
+        // Les mostres de fora del rectangle van a la cel·la de la vora
+        int cx = lodCell(samples[j].x - mapping->Rxmin, cellX, nx);
+        int cz = lodCell(samples[j].y - mapping->Rzmin, cellZ, nz);
+        cells[j] = (uint32_t)cx * (uint32_t)nz + (uint32_t)cz;
+    }
 
-    auto tCM = propinfo->colorMapType;
-    auto cm = make_shared<ColorMapStatic>(tCM);
+    // Cada cel·la dona una mostra a la posició mitjana de les seves mostres: una
+    // cel·la amb una sola mostra la deixa igual. En els dos casos les cel·les surten
+    // en ordre de x i z i cada cel·la acumula les mostres en l'ordre del fitxer
+    uint64_t numCells = (uint64_t)nx * (uint64_t)nz;
+    if (numCells <= 4 * (uint64_t)samples.size()) {
+        // Graella densa: un sol recorregut de les mostres
+        vector<LodBin> bins(numCells);
+        for (size_t j = 0; j < samples.size(); j++)
+            bins[cells[j]].add(samples[j]);
+        for (uint64_t c = 0; c < numCells; c++)
+            if (bins[c].count > 0) out.push_back(bins[c].sample(propinfo->lod));
+    } else {
+        // Massa cel·les buides: s'ordenen les mostres per cel·la (als 32 bits alts de
+        // la clau) i índex (als baixos)
+        vector<uint64_t> keys(samples.size());
+        for (size_t j = 0; j < samples.size(); j++)
+            keys[j] = ((uint64_t)cells[j] << 32) | (uint64_t)j;
+        std::sort(keys.begin(), keys.end());
+
+        size_t k = 0;
+        while (k < keys.size()) {
+            uint64_t cell = keys[k] >> 32;
+            LodBin bin;
+            for (; k < keys.size() && (keys[k] >> 32) == cell; k++)
+                bin.add(samples[(uint32_t)keys[k]]);
+            out.push_back(bin.sample(propinfo->lod));
+        }
+    }
+}
 
-    float valorDada = dades[i].second[j][2];
+int SceneFactoryData::lodCell(float offset, float cellSize, int n) {
+    // Es retalla en float: convertir a int un valor fora del rang d'int (o NaN) no
+    // està definit
+    float c = std::floor(offset / cellSize);
+    if (!(c > 0.0f)) return 0;
+    if (c >= (float)(n - 1)) return n - 1;
+    return (int)c;
+}
+
+vec2 SceneFactoryData::sampleRange(const vector<vec3> &samples, vec2 defaultRange) {
+    // Els valors no finits no entren al rang: només farien que la resta de mostres
+    // quedessin totes a un extrem de la paleta
+    float minValue = std::numeric_limits<float>::infinity();
+    float maxValue = -std::numeric_limits<float>::infinity();
+    for (unsigned int j = 0; j < samples.size(); j++) {
+        float v = samples[j].z;
+        if (!std::isfinite(v)) continue;
+        minValue = std::min(minValue, v);
+        maxValue = std::max(maxValue, v);
+    }
+    if (minValue > maxValue) return defaultRange;
+    return vec2(minValue, maxValue);
+}
+
+void SceneFactoryData::LodBin::add(const vec3 &sample) {
+    sumX += sample.x;
+    sumZ += sample.y;
+    sumValue += sample.z;
+    maxValue = std::max(maxValue, sample.z);
+    count++;
+}
+
+vec3 SceneFactoryData::LodBin::sample(AttributeMapping::LOD_TYPES lod) const {
+    float value;
+    switch (lod) {
+    case AttributeMapping::SUM:
+        value = (float)sumValue;
+        break;
+    case AttributeMapping::MAX:
+        value = maxValue;
+        break;
+    default:
+        value = (float)(sumValue / count);
+    }
+    return vec3((float)(sumX / count), (float)(sumZ / count), value);
+}
 
-    auto tMat = MaterialFactory::getInstance().getIndexType(propinfo->material);
+int SceneFactoryData::paletteIndex(int i, int j) const {
+    float valorDada = (*gizmoData[i])[j][2];
+    float minValue = valueRanges[i].x;
+    float maxValue = valueRanges[i].y;
+
+    // Calcul de l'index de la paleta. Un rang buit o un valor NaN (per exemple d'un
+    // fitxer FLOAT32) van a la primera entrada: NaN no es pot convertir a enter
+    float range = maxValue - minValue;
+    if (range == 0.0f) return 0;
+    float f = (valorDada-minValue)/range;
+    if (!(f > 0.0f)) return 0;
+    int idx = (int)((PALETTE_SIZE - 1)*std::min(f, 1.0f));
+    return std::min(std::max(idx, 0), PALETTE_SIZE - 1);
+}
+
+shared_ptr<Material> SceneFactoryData::materialMaps(int i,  int j) {
+    // Es fa servir el color de l'entrada (sense interpolar) perquè totes les dades
+    // d'una entrada comparteixin material
+    return paletteMaterials[i][paletteIndex(i, j)];
+}
+
+void SceneFactoryData::buildPaletteMaterials() {
+    paletteMaterials.assign(dades.size(), vector<shared_ptr<Material>>());
+    for (unsigned int i = 0; i < dades.size(); i++) {
+        AttributeMapping *propinfo = mapping->attributeMapping[i];
+
+        // Paleta compartida: no es copia cap taula
+        const ColorMapStatic &cm = ColorMapStatic::getInstance(propinfo->colorMapType);
+        auto tMat = MaterialFactory::getInstance().getIndexType(propinfo->material);
+
+        paletteMaterials[i].resize(PALETTE_SIZE);
+        for (int idx = 0; idx < PALETTE_SIZE; idx++)
+            paletteMaterials[i][idx] = internMaterial(propinfo->material->Ka,
+                                                      cm.getColor(idx),
+                                                      propinfo->material->Ks,
+                                                      propinfo->material->shininess,
+                                                      propinfo->material->opacity, tMat);
+    }
+}
+
+SceneFactoryData::MaterialKey::MaterialKey(vec3 a, vec3 d, vec3 s, float beta, float opacity,
+                                           MaterialFactory::MATERIAL_TYPES t) {
+    type = t;
+    for (int k = 0; k < 3; k++) {
+        values[k] = a[k];
+        values[3+k] = d[k];
+        values[6+k] = s[k];
+    }
+    values[9] = beta;
+    values[10] = opacity;
+}
+
+bool SceneFactoryData::MaterialKey::operator<(const MaterialKey &other) const {
+    if (type != other.type) return type < other.type;
+    return std::lexicographical_compare(values, values + 11, other.values, other.values + 11);
+}
 
-    // Calcul de l'index de la paleta
-    int idx = (int)(255.0*(valorDada-propinfo->minValue)/(propinfo->maxValue-propinfo->minValue));
+shared_ptr<Material> SceneFactoryData::internMaterial(vec3 a, vec3 d, vec3 s, float beta, float opacity,
+                                                      MaterialFactory::MATERIAL_TYPES t) {
+    MaterialKey key(a, d, s, beta, opacity, t);
+    auto found = materials.find(key);
+    if (found != materials.end()) return found->second;
 
-    return MaterialFactory::getInstance().createMaterial(propinfo->material->Ka,
-                                                         cm->getColor(idx),
-                                                         propinfo->material->Ks,
-                                                         propinfo->material->shininess,
-                                                         propinfo->material->opacity, tMat);
+    shared_ptr<Material> m = MaterialFactory::getInstance().createMaterial(a, d, s, beta, opacity, t);
+    materials[key] = m;
+    return m;
 }
 
 vec3 SceneFactoryData::getPuntBase(ObjectFactory::OBJECT_TYPES gyzmo, vec2 puntReal) {
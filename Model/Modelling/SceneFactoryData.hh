@@ -1,10 +1,15 @@
 #pragma once
 
+#include <limits>
+#include <map>
+
 #include "Model/Modelling/Materials/ColorMapStatic.hh"
 #include "Model/Modelling/Materials/Material.hh"
 #include "Model/Modelling/SceneFactory.hh"
 #include "Model/Modelling/Materials/MaterialFactory.hh"
 #include "DataInOut/VisualMapping.hh"
+#include "DataInOut/DataFileReader.hh"
+#include "Model/Rendering/Camera.hh"
 
 class SceneFactoryData : public SceneFactory
 {
@@ -12,6 +17,92 @@ class SceneFactoryData : public SceneFactory
     vector<pair<QString, vector<vec3>>> dades;
     shared_ptr<VisualMapping> mapping;
 
+    // Fitxer de dades extern de cada atribut de dades ("dataFile" i "format").
+    // fileName és buit si les dades eren dins del JSON ("data")
+    struct DataSource
+    {
+        QString fileName;
+        DataFileReader::FORMATS format;
+    };
+    vector<DataSource> dataSources;
+
+    // Directori del fitxer de l'escena: els "dataFile" relatius hi fan referència
+    QString sceneDir;
+
+    // Atributs de l'últim read() que s'han descartat perquè no tenien dades
+    int missingData = 0;
+
+    // Clau d'un material: tipus i tots els seus coeficients. Dos materials amb la
+    // mateixa clau són iguals i es poden compartir
+    struct MaterialKey
+    {
+        MaterialFactory::MATERIAL_TYPES type;
+        float values[11];   // Ka, Kd, Ks, shininess, opacity
+
+        MaterialKey(vec3 a, vec3 d, vec3 s, float beta, float opacity, MaterialFactory::MATERIAL_TYPES t);
+        bool operator<(const MaterialKey &other) const;
+    };
+
+    // Materials ja creats per a l'escena que s'està construint. Com que la paleta
+    // només té 256 colors, n'hi ha com a molt uns centenars per atribut en lloc
+    // d'un per gizmo
+    std::map<MaterialKey, shared_ptr<Material>> materials;
+
+    // Retorna el material de la taula amb aquests coeficients i, si no hi és, el
+    // crea amb MaterialFactory i l'hi afegeix
+    shared_ptr<Material> internMaterial(vec3 a, vec3 d, vec3 s, float beta, float opacity,
+                                        MaterialFactory::MATERIAL_TYPES t);
+
+    // Material de cada entrada de la paleta de cada atribut. Es creen abans de
+    // construir els gizmos perquè materialMaps() només hagi de llegir i es pugui
+    // cridar des de diversos threads alhora
+    static const int PALETTE_SIZE = 256;
+    vector<vector<shared_ptr<Material>>> paletteMaterials;
+    void buildPaletteMaterials();
+    int  paletteIndex(int i, int j) const;
+
+    // Mostres consecutives que construeix cada thread de visualMaps() d'una tirada
+    static const int GIZMO_CHUNK = 4096;
+
+    // Mostres de les que es construeixen els gizmos de cada atribut: les dades
+    // llegides o, si l'atribut té "lod", les agregades a lodSamples
+    vector<const vector<vec3>*> gizmoData;
+    vector<vector<vec3>>        lodSamples;
+
+    // Rang de valors (mínim, màxim) amb què paletteIndex() tria el color de cada
+    // atribut: minValue i maxValue de l'atribut o, amb "lod": SUM, el de les sumes
+    vector<vec2> valueRanges;
+
+    // Mínim i màxim dels valors finits de les mostres. defaultRange si no n'hi ha cap
+    static vec2 sampleRange(const vector<vec3> &samples, vec2 defaultRange);
+
+    // Càmera amb què es calcula la mida d'un píxel al centre del món virtual. Si no
+    // n'hi ha, la graella té LOD_DEFAULT_BINS cel·les per costat
+    shared_ptr<Camera> footprintCamera;
+    static const int LOD_DEFAULT_BINS = 512;
+    static const int LOD_MAX_BINS = 65535;
+
+    // Mostres d'una cel·la de la graella de nivell de detall
+    struct LodBin
+    {
+        double sumX = 0.0, sumZ = 0.0, sumValue = 0.0;
+        float  maxValue = -std::numeric_limits<float>::infinity();
+        int    count = 0;
+
+        void add(const vec3 &sample);
+        // Mostra agregada: posició mitjana i valor segons lod
+        vec3 sample(AttributeMapping::LOD_TYPES lod) const;
+    };
+
+    // Agrega les mostres de l'atribut i en una mostra per cel·la de la graella
+    // sobre el rectangle del món real (Rxmin..Rxmax, Rzmin..Rzmax)
+    void aggregateSamples(int i, vector<vec3> &out) const;
+
+    // Cel·la 0..n-1 on cau la distància offset amb cel·les de mida cellSize. Les
+    // distàncies de fora del rectangle (i les infinites) van a la cel·la de la vora
+    // i les NaN a la primera
+    static int lodCell(float offset, float cellSize, int n);
+
 public:
     SceneFactoryData() {};
     SceneFactoryData(shared_ptr<VisualMapping> mapping);
@@ -22,12 +113,19 @@ public:
     virtual void write (QJsonObject &json) const override;
     virtual void print (int indentation) const override;
 
+    // Fa servir la càmera per triar la mida de les cel·les dels atributs amb "lod":
+    // un gizmo per cada píxel que ocupa el món virtual. Cal cridar-ho abans de
+    // createScene()
+    void setFootprint(shared_ptr<Camera> camera);
+
     bool load (QString nameFile);
     bool save (QString nameFile) const;
 
     vec3 getPuntBase(ObjectFactory::OBJECT_TYPES gyzmo, vec2 puntReal);
 
-    void readData(const QJsonObject &json);
+    // Afegeix a dades les mostres de l'atribut. Retorna fals, sense afegir res, si
+    // no en té o no s'han pogut llegir
+    bool readData(const QJsonObject &json);
     void writeData (QJsonObject &json, int i) const ;
 
     shared_ptr<Scene>    visualMaps();
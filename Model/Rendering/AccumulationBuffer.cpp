@@ -0,0 +1,45 @@
+#include "AccumulationBuffer.hh"
+
+void AccumulationBuffer::reset(int width, int height) {
+    lock_guard<mutex> lock(access);
+    this->width = width;
+    this->height = height;
+    sum.assign((size_t)width * height, vec3(0.0f));
+    count.assign((size_t)width * height, 0.0f);
+    preview.assign((size_t)width * height, vec3(0.0f));
+}
+
+void AccumulationBuffer::addTile(const Tile &tile, const vector<vec3> &colors) {
+    lock_guard<mutex> lock(access);
+    int i = 0;
+    for (int y = tile.y0; y < tile.y1; y++) {
+        for (int x = tile.x0; x < tile.x1; x++, i++) {
+            size_t p = (size_t)y * width + x;
+            sum[p] += colors[i];
+            count[p] += 1.0f;
+        }
+    }
+}
+
+void AccumulationBuffer::setPreviewTile(const Tile &tile, const vector<vec3> &colors) {
+    lock_guard<mutex> lock(access);
+    int i = 0;
+    for (int y = tile.y0; y < tile.y1; y++)
+        for (int x = tile.x0; x < tile.x1; x++, i++)
+            preview[(size_t)y * width + x] = colors[i];
+}
+
+void AccumulationBuffer::resolve(QImage &image, float gamma) const {
+    FrameBuffer average;
+    {
+        lock_guard<mutex> lock(access);
+        average.resize(width, height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                size_t p = (size_t)y * width + x;
+                average.set(x, y, count[p] > 0.0f ? sum[p] / count[p] : preview[p]);
+            }
+        }
+    }
+    average.toImage(image, gamma);
+}
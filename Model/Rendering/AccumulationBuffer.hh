@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <QImage>
+
+#include "glm/glm.hpp"
+#include "TileScheduler.hh"
+#include "FrameBuffer.hh"
+
+using namespace std;
+using namespace glm;
+
+// Buffer de color en float per al render progressiu. Per a cada pixel guarda la
+// suma de les mostres calculades i quantes n'hi ha; mentre un pixel no té cap
+// mostra es mostra el color de la previsualització a baixa resolució.
+// Els threads del render hi afegeixen tiles sencers i la interfície en pot
+// treure una imatge en qualsevol moment: tots dos accessos van protegits per un
+// mutex, que només es bloqueja un cop per tile.
+class AccumulationBuffer
+{
+public:
+    AccumulationBuffer() {};
+
+    // Canvia la mida i esborra totes les mostres
+    void reset(int width, int height);
+
+    // Suma les mostres d'un tile. colors té (x1-x0)*(y1-y0) valors per files
+    void addTile(const Tile &tile, const vector<vec3> &colors);
+
+    // Omple el tile de la previsualització
+    void setPreviewTile(const Tile &tile, const vector<vec3> &colors);
+
+    // Escriu la mitjana de cada pixel a image (de la mateixa mida que el buffer)
+    void resolve(QImage &image, float gamma = 1.0f) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    int width = 0;
+    int height = 0;
+    vector<vec3>  sum;
+    vector<float> count;
+    vector<vec3>  preview;
+
+    mutable mutex access;
+};
@@ -69,18 +69,18 @@ void Camera::computeAtributes(vec3 lookfrom,
     }
 }
 
-Ray Camera::getRay(float s, float t) {
+Ray Camera::getRay(float s, float t) const {
     if (!defocus_blur)
-        return Ray(origin, lower_left_corner + s*horizontal + t*vertical - origin);
+        return Ray(origin, lower_left_corner + s*horizontal + t*vertical - origin, 0.0f);
     //Si s'ha de fer defocus blur, retornem el raig blur
     return getBlurRay(s, t);
 }
 
-Ray Camera::getBlurRay(float s, float t) {
+Ray Camera::getBlurRay(float s, float t) const {
     vec3 n_origin = origin;
     vec3 random_in_disk = lens_radius*random_in_unit_disk();
     n_origin = n_origin + u*random_in_disk.x + v*random_in_disk.y;
-    return Ray(n_origin, lower_left_corner + s*horizontal + t*vertical - n_origin);
+    return Ray(n_origin, lower_left_corner + s*horizontal + t*vertical - n_origin, 0.0f);
 }
 
 
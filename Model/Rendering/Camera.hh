@@ -9,6 +9,7 @@
 #include "glm/gtc/matrix_transform.hpp"
 
 #include "Model/Modelling/Ray.hh"
+#include "Model/Modelling/Random.hh"
 #include "DataInOut/Serializable.hh"
 
 using namespace glm;
@@ -32,16 +33,16 @@ public:
                            double aspect_ratio, double pixelsX,
                            bool defocus_blur, double lensRadius);
 
-    Ray   getRay(float s, float t);
+    Ray   getRay(float s, float t) const;
 
-    vec3  getLookFrom() {return origin; }
+    vec3  getLookFrom() const {return origin; }
     vec3  getLookAt() { return vrp; }
     float getAspectRatio() { return aspectRatio; }
     vec3  getVUP() { return v;}
     float getFOV()  {return vfov; }
     float getAperture() { return lens_radius * 2.0;}
     bool  getDefocusBlur() { return defocus_blur;}
-    Ray   getBlurRay(float s, float t);
+    Ray   getBlurRay(float s, float t) const;
 
     void changeAttributeMappings(vec3 lookfrom,
                           vec3 lookat,
@@ -50,7 +51,8 @@ public:
     static vec3 random_in_unit_disk() {
         vec3 p;
         do {
-            p = 2.0f*vec3(double(rand())/RAND_MAX,double(rand())/RAND_MAX,0) - vec3(1,1,0);
+            Random &rng = Random::local();
+            p = 2.0f*vec3(rng.nextFloat(), rng.nextFloat(), 0) - vec3(1,1,0);
         } while (dot(p,p) >= 1.0);
         return p;
     }
@@ -1,5 +1,5 @@
 #include "ColorShading.hh"
 
-vec3 ColorShading::shading(shared_ptr<Scene> scene, HitInfo& info, vec3 lookFrom) {
+vec3 ColorShading::shading(const RenderContext &context, const HitInfo &info) const {
     return info.mat_ptr->Kd;
 }
@@ -6,7 +6,7 @@ class ColorShading: public ShadingStrategy
 {
 public:
     ColorShading() {};
-    vec3 shading(shared_ptr<Scene> scene, HitInfo& info, vec3 lookFrom) override;
+    vec3 shading(const RenderContext &context, const HitInfo &info) const override;
     ~ColorShading(){};
 };
 
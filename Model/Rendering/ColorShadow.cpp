@@ -1,6 +1,26 @@
 #include "ColorShadow.hh"
 
-vec3 ColorShadow::shading(shared_ptr<Scene> scene, HitInfo& info, vec3 lookFrom) {
-    // TODO: Fase 2: Canviar per a considerar les ombres en aquest shading
-    return vec3(1.0)-info.mat_ptr->Kd;
+vec3 ColorShadow::shading(const RenderContext &context, const HitInfo &info) const {
+    // Un raig d'ombra per cada llum escollida des d'aquest punt. El vector de les
+    // mostres es reutilitza entre crides del mateix thread: aquest camí es crida un
+    // cop per impacte i no ha de reservar memòria cada vegada
+    static thread_local vector<LightSample> samples;
+    if (samples.size() < (size_t)context.maxLightSamples())
+        samples.resize(context.maxLightSamples());
+    int numSamples = context.sampleLights(info, Random::local(), samples.data());
+    for (int i = 0; i < numSamples; i++)
+        samples[i].weight *= computeShadow(*context.scene, *samples[i].light, info);
+    return shadingWithVisibility(context, info, samples.data(), numSamples);
+}
+
+vec3 ColorShadow::shadingWithVisibility(const RenderContext &context, const HitInfo &info,
+                                        const LightSample *samples, int numSamples) const {
+    if (context.lights.empty()) return info.mat_ptr->Kd;
+
+    vec3 intensity = context.globalLight;
+    for (int i = 0; i < numSamples; i++) {
+        if (samples[i].weight > 0.0f)
+            intensity += samples[i].weight * samples[i].light->getId() * samples[i].light->attenuation(info.p);
+    }
+    return info.mat_ptr->Kd * intensity;
 }
@@ -2,11 +2,16 @@
 
 #include "ShadingStrategy.hh"
 
+// Color de l'objecte amb ombres: Kd * (llum global + suma de Id * atenuació de
+// cada llum que veu el punt). Sense llums és el mateix que ColorShading. Amb moltes
+// llums i lightSamples al setup, la suma s'estima amb unes poques llums escollides.
 class ColorShadow : public ShadingStrategy
 {
 public:
     ColorShadow(){};
-    vec3 shading(shared_ptr<Scene> scene, HitInfo& info, vec3 lookFrom) override;
+    vec3 shading(const RenderContext &context, const HitInfo &info) const override;
+    vec3 shadingWithVisibility(const RenderContext &context, const HitInfo &info,
+                               const LightSample *samples, int numSamples) const override;
+    bool usesShadows() const override { return true; }
     ~ColorShadow() {};
 };
-
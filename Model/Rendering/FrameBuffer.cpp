@@ -0,0 +1,55 @@
+#include "FrameBuffer.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Clamp i quantització d'una fila: c*255 limitat a [0, 255] i truncat, com feia
+// setPixel. Sense branques perquè el compilador ho pugui vectoritzar. Els NaN
+// queden a 0.
+void quantizeRow(const float *src, uchar *dst, int n) {
+    for (int i = 0; i < n; i++) {
+        float v = std::max(0.0f, src[i] * 255.0f);
+        dst[i] = (uchar)std::min(255.0f, v);
+    }
+}
+
+}
+
+void FrameBuffer::resize(int width, int height) {
+    this->width = width;
+    this->height = height;
+    rgb.assign((size_t)width * height * 3, 0.0f);
+}
+
+void FrameBuffer::toImage(QImage &image, float gamma) const {
+    if (image.width() != width || image.height() != height) return;
+
+    int rowSize = width * 3;
+    vector<float> corrected;
+    if (gamma != 1.0f) corrected.resize(rowSize);
+
+    vector<uchar> converted;
+    bool direct = image.format() == QImage::Format_RGB888;
+    if (!direct) converted.resize(rowSize);
+
+    for (int y = 0; y < height; y++) {
+        const float *src = &rgb[(size_t)y * rowSize];
+        if (gamma != 1.0f) {
+            float invGamma = 1.0f / gamma;
+            for (int i = 0; i < rowSize; i++)
+                corrected[i] = std::pow(std::min(std::max(src[i], 0.0f), 1.0f), invGamma);
+            src = corrected.data();
+        }
+
+        // Les QImage RGB888 tenen els tres bytes de cada pixel seguits, com el buffer
+        if (direct) {
+            quantizeRow(src, image.scanLine(y), rowSize);
+        } else {
+            quantizeRow(src, converted.data(), rowSize);
+            for (int x = 0; x < width; x++)
+                image.setPixelColor(x, y, QColor(converted[3*x], converted[3*x+1], converted[3*x+2]));
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <QImage>
+
+#include "glm/glm.hpp"
+
+using namespace std;
+using namespace glm;
+
+// Imatge en float (RGB lineal, sense limitar a [0, 1]) on el RayTracer escriu els
+// colors dels pixels. La conversió a 8 bits (clamp, correcció gamma i
+// quantització) es fa de cop al final sobre tot el buffer i s'escriu directament
+// a les scanlines de la QImage.
+class FrameBuffer
+{
+public:
+    FrameBuffer() {};
+    FrameBuffer(int width, int height) { resize(width, height); }
+
+    void resize(int width, int height);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    void set(int x, int y, const vec3 &color) {
+        float *p = &rgb[((size_t)y * width + x) * 3];
+        p[0] = color.r;
+        p[1] = color.g;
+        p[2] = color.b;
+    }
+
+    vec3 get(int x, int y) const {
+        const float *p = &rgb[((size_t)y * width + x) * 3];
+        return vec3(p[0], p[1], p[2]);
+    }
+
+    const float *data() const { return rgb.data(); }
+
+    // Converteix el buffer a 8 bits i l'escriu a image, que ha de tenir la mateixa
+    // mida. Amb gamma != 1 es fa la correcció c^(1/gamma)
+    void toImage(QImage &image, float gamma = 1.0f) const;
+
+private:
+    int width = 0;
+    int height = 0;
+    vector<float> rgb;
+};
@@ -1,5 +1,5 @@
 #include "NormalShading.hh"
 
-vec3 NormalShading::shading(shared_ptr<Scene> scene, HitInfo& info, vec3 lookFrom) {
+vec3 NormalShading::shading(const RenderContext &context, const HitInfo &info) const {
     return info.normal;
 }
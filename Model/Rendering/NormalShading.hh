@@ -6,6 +6,6 @@ class NormalShading: public ShadingStrategy
 {
 public:
     NormalShading() {};
-    vec3 shading(shared_ptr<Scene> scene, HitInfo& info, vec3 lookFrom) override;
+    vec3 shading(const RenderContext &context, const HitInfo &info) const override;
     ~NormalShading(){};
 };
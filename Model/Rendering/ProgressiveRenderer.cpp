@@ -0,0 +1,46 @@
+#include "ProgressiveRenderer.hh"
+#include "RayTracer.hh"
+
+void ProgressiveRenderer::start() {
+    stop();
+
+    // Còpia del setup i de la càmera: els canvis que es facin a la interfície
+    // mentre es calcula no afecten el render en curs
+    auto setup = make_shared<SetUp>(*Controller::getInstance()->getSetUp());
+    setup->setCamera(make_shared<Camera>(*setup->getCamera()));
+    auto scene = Controller::getInstance()->getScene();
+
+    accum.reset(setup->getCamera()->viewportX, setup->getCamera()->viewportY);
+    samplesDone = 0;
+    gamma = setup->getGamma();
+    cancel = false;
+    running = true;
+    worker = thread(&ProgressiveRenderer::loop, this, scene, setup);
+}
+
+void ProgressiveRenderer::stop() {
+    cancel = true;
+    if (worker.joinable())
+        worker.join();
+    running = false;
+}
+
+bool ProgressiveRenderer::resolve(QImage &image) const {
+    if (accum.getWidth() == 0 || image.width() != accum.getWidth() || image.height() != accum.getHeight())
+        return false;
+    accum.resolve(image, gamma);
+    return true;
+}
+
+void ProgressiveRenderer::loop(shared_ptr<Scene> scene, shared_ptr<SetUp> setup) {
+    RayTracer tracer(nullptr);
+    tracer.scene = scene;
+    tracer.setup = setup;
+
+    int samples = std::max(setup->getSamples(), 1);
+    for (int pass = 0; pass <= samples; pass++) {
+        if (!tracer.runPass(pass, accum, cancel)) break;
+        if (pass > 0) samplesDone = pass;
+    }
+    running = false;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <QImage>
+
+#include "AccumulationBuffer.hh"
+#include "SetUp.hh"
+#include "Model/Modelling/Scene.hh"
+
+using namespace std;
+
+// Render progressiu en un thread de fons. Primer fa una previsualització a baixa
+// resolució i després va acumulant mostres a cada pixel fins arribar a les
+// mostres del setup. Mentrestant, la interfície pot demanar la imatge amb el
+// progrés actual amb resolve().
+// El render treballa sobre una còpia del setup i de la càmera, de manera que es
+// poden canviar des de la interfície i tornar a cridar start() per reiniciar
+// l'acumulació.
+class ProgressiveRenderer
+{
+public:
+    ProgressiveRenderer() {};
+    ~ProgressiveRenderer() { stop(); }
+
+    // Comença un render nou amb l'escena i el setup actuals del Controller. Si ja
+    // n'hi havia un en marxa, es cancel·la i se'n descarten les mostres
+    void start();
+
+    // Cancel·la el render i espera que acabi el thread
+    void stop();
+
+    bool isRunning() const { return running; }
+
+    // Mostres per pixel acumulades fins ara
+    int  getSamples() const { return samplesDone; }
+
+    // Escriu a image el progrés actual. Retorna fals si no hi ha cap render
+    // començat o si image no té la mida del render
+    bool resolve(QImage &image) const;
+
+private:
+    void loop(shared_ptr<Scene> scene, shared_ptr<SetUp> setup);
+
+    AccumulationBuffer accum;
+    thread             worker;
+    atomic<bool>       cancel{false};
+    atomic<bool>       running{false};
+    atomic<int>        samplesDone{0};
+    float              gamma = 1.0f;
+};
@@ -1,5 +1,27 @@
 #include "RayTracer.hh"
 
+#include <algorithm>
+
+namespace {
+
+// Pas coprimer amb n, proper a n/phi: recorrent els estrats amb i*pas % n es
+// visiten tots un cop i els primers queden repartits per tot el pixel
+int stratumStride(int n) {
+    int stride = std::max((int)(n * 0.618f), 1);
+    while (stride > 1) {
+        int a = n, b = stride;
+        while (b != 0) {
+            int t = a % b;
+            a = b;
+            b = t;
+        }
+        if (a == 1) break;
+        stride--;
+    }
+    return stride;
+}
+
+}
 
 RayTracer::RayTracer(QImage *i):
     image(i) {
@@ -12,45 +34,319 @@ RayTracer::RayTracer(QImage *i):
 void RayTracer::run() {
 
     init();
-    auto camera = setup->getCamera();
+    int  width = context.camera->viewportX;
+    int  height = context.camera->viewportY;
+
+    // Cada thread només escriu els pixels dels seus tiles al framebuffer
+    framebuffer.resize(width, height);
+
+    TileScheduler scheduler(width, height, setup->getNumThreads());
+    mutex progressMutex;
+    atomic<unsigned long long> tracedRays(0);
+    atomic<unsigned long long> primaryRays(0);
+
+    // Mapa de colors per a la imatge de depuració de les mostres per pixel
+    bool heatmap = setup->getSamplesHeatmap();
+    int  maxSamples = std::max(setup->getSamples(), 1);
+    const ColorMapStatic &heatmapColors = ColorMapStatic::getInstance(ColorMapStatic::COLOR_MAP_TYPE_INFERNO);
+
+    // Amb una sola mostra per pixel els tiles es calculen per fases (renderTile)
+    bool tiled = setup->getSamples() <= 1 && !heatmap;
+
+    stats = RenderStats();
+    stats.width = width;
+    stats.height = height;
+    stats.numThreads = scheduler.getNumThreads();
+    auto start = chrono::steady_clock::now();
+
+    scheduler.run([&](const Tile &tile, int) {
+        unsigned long long raysBefore = Scene::tracedRays();
+        unsigned long long tileSamples = 0;
+        if (tiled) {
+            renderTile(tile, width, height);
+            tileSamples = (unsigned long long)(tile.x1 - tile.x0) * (tile.y1 - tile.y0);
+        } else {
+            for (int y = tile.y1-1; y >= tile.y0; y--) {
+                for (int x = tile.x0; x < tile.x1; x++) {
+
+                    int  samplesUsed;
+                    vec3 color = samplePixel(x, y, width, height, samplesUsed);
+                    tileSamples += samplesUsed;
+                    if (heatmap)
+                        color = heatmapColors.getInterpolatedColor((float)samplesUsed / maxSamples);
+
+                    setPixel(x, y, color);
+                }
+            }
+        }
+        tracedRays += Scene::tracedRays() - raysBefore;
+        primaryRays += tileSamples;
+    }, [&](int tilesRemaining) {
+        // Progrés del càlcul
+        lock_guard<mutex> lock(progressMutex);
+        std::cerr << "\rTiles remaining: " << tilesRemaining << ' ' << std::flush;
+    });
+    std::cerr << "\n";
+
+    // Clamp, correcció gamma i pas a 8 bits de tota la imatge
+    framebuffer.toImage(*image, setup->getGamma());
+
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.primaryRays = primaryRays;
+    stats.totalRays = tracedRays;
+}
+
+
+bool RayTracer::runPass(int pass, AccumulationBuffer &accum, const atomic<bool> &cancel) {
+    if (pass == 0) init();
+
+    const Camera *camera = context.camera;
     int  width = camera->viewportX;
     int  height = camera->viewportY;
 
-    for (int y = height-1; y >= 0; y--) {
-        std::cerr << "\rScanlines remaining: " << y << ' ' << std::flush;  // Progrés del càlcul
-        for (int x = 0; x < width; x++) {
+    TileScheduler scheduler(width, height, setup->getNumThreads());
+    scheduler.run([&](const Tile &tile, int) {
+        if (cancel) return;
 
-            //TODO FASE 2: mostrejar més rajos per pixel segons el valor de "samples"
+        int tileWidth = tile.x1 - tile.x0;
+        vector<vec3> colors(tileWidth * (tile.y1 - tile.y0));
 
-            float u = (float(x)) / float(width);
-            float v = (float(height -y)) / float(height);
-            vec3 color(0, 0, 0);
+        if (pass == 0) {
+            // Un sol raig per bloc, amb el qual s'omple tot el bloc
+            for (int by = tile.y0; by < tile.y1; by += PREVIEW_BLOCK) {
+                for (int bx = tile.x0; bx < tile.x1; bx += PREVIEW_BLOCK) {
+                    Ray r = camera->getRay(float(bx) / float(width), float(height - by) / float(height));
+                    vec3 color = RayPixel(r);
+                    for (int y = by; y < std::min(by + PREVIEW_BLOCK, tile.y1); y++)
+                        for (int x = bx; x < std::min(bx + PREVIEW_BLOCK, tile.x1); x++)
+                            colors[(y - tile.y0) * tileWidth + (x - tile.x0)] = color;
+                }
+            }
+            accum.setPreviewTile(tile, colors);
+            return;
+        }
+
+        Random &rng = Random::local();
+        for (int y = tile.y0; y < tile.y1; y++) {
+            for (int x = tile.x0; x < tile.x1; x++) {
+                // Cada passada fa servir una seqüència diferent de nombres aleatoris
+                rng.setSeed(context.seed + (uint64_t)pass * 0x9E3779B97F4A7C15ULL, (uint64_t)y * width + x);
+                float u = (float(x) + rng.nextFloat()) / float(width);
+                float v = (float(height - y - 1) + rng.nextFloat()) / float(height);
+                Ray r = camera->getRay(u, v);
+                colors[(y - tile.y0) * tileWidth + (x - tile.x0)] = RayPixel(r);
+            }
+        }
+        accum.addTile(tile, colors);
+    });
+    return !cancel;
+}
 
-            Ray r = camera->getRay(u, v);
 
-            color = this->RayPixel(r);
+// Color mig del pixel (x, y) amb setup->getSamples() rajos. Amb més d'una mostra,
+// el pixel es divideix en una graella de sx x sx estrats i a cada estrat es
+// llença un raig en una posició aleatòria (jittered sampling). Les mostres que no
+// omplen una graella quadrada es reparteixen a l'atzar per tot el pixel.
+// Amb mostreig adaptatiu es va calculant la variància de la lluminància de les
+// mostres (Welford) i el pixel s'acaba quan l'error estàndard de la mitjana és
+// menor que el llindar del setup. samplesUsed retorna les mostres calculades.
+vec3 RayTracer::samplePixel(int x, int y, int width, int height, int &samplesUsed) {
+    const Camera *camera = context.camera;
+    int  samples = setup->getSamples();
 
-            // TODO FASE 2: Gamma correction
+    // Els nombres aleatoris del pixel només depenen de (x, y) i de la llavor
+    Random &rng = Random::local();
+    rng.setSeed(context.seed, (uint64_t)y * width + x);
 
-            color *= 255;
-            setPixel(x, y, color);
+    if (samples <= 1) {
+        samplesUsed = 1;
+        Ray r = camera->getRay(float(x) / float(width), float(height - y) / float(height));
+        return RayPixel(r);
+    }
+
+    int   sx = (int)sqrt((float)samples);
+    int   strata = sx*sx;
+    float threshold = setup->getAdaptiveThreshold();
+    bool  adaptive = threshold > 0.0f;
+    int   minSamples = std::min(std::max(setup->getAdaptiveMinSamples(), 2), samples);
+    // Si el pixel es pot acabar abans d'hora, els estrats no es recorren per files
+    int   stride = adaptive ? stratumStride(strata) : 1;
+
+    vec3  color(0, 0, 0);
+    float mean = 0.0f, m2 = 0.0f;
+    int   n = 0;
+    for (int i = 0; i < samples; i++) {
+        float dx, dy;
+        if (i < strata) {
+            int s = (int)(((long long)i * stride) % strata);
+            dx = ((s % sx) + rng.nextFloat()) / sx;
+            dy = ((s / sx) + rng.nextFloat()) / sx;
+        } else {
+            dx = rng.nextFloat();
+            dy = rng.nextFloat();
+        }
+        float u = (float(x) + dx) / float(width);
+        float v = (float(height - y - 1) + dy) / float(height);
+        Ray r = camera->getRay(u, v);
+        vec3 c = RayPixel(r);
+        color += c;
+        n++;
+
+        if (adaptive) {
+            float l = dot(c, vec3(0.2126f, 0.7152f, 0.0722f));
+            float delta = l - mean;
+            mean += delta / n;
+            m2 += delta * (l - mean);
+            if (n >= minSamples && sqrt(m2 / (float(n - 1) * n)) <= threshold) break;
         }
     }
+    samplesUsed = n;
+    return color / float(n);
 }
 
 
-void RayTracer::setPixel(int x, int y, vec3 color) {
+// Calcula el tile per fases: primer la interseccio dels rajos primaris de tots els
+// pixels, després els rajos d'ombra agrupats per llum i finalment el shading. Els rajos
+// d'ombra des de pixels veïns cap a una mateixa llum són coherents i recorren les
+// mateixes branques del BVH un darrere l'altre.
+void RayTracer::renderTile(const Tile &tile, int width, int height) {
+    int tileWidth = tile.x1 - tile.x0;
+    int n = tileWidth * (tile.y1 - tile.y0);
+    vector<Ray>     rays(n);
+    vector<HitInfo> infos(n);
+    vector<char>    hits(n);
+
+    if (context.rayPackets) {
+        tracePackets(tile, width, height, rays, infos, hits);
+    } else {
+        Random &rng = Random::local();
+        for (int i = 0; i < n; i++) {
+            int x = tile.x0 + i % tileWidth;
+            int y = tile.y0 + i / tileWidth;
+            rng.setSeed(context.seed, (uint64_t)y * width + x);
+            rays[i] = context.camera->getRay(float(x) / float(width), float(height - y) / float(height));
+            hits[i] = context.scene->hit(rays[i], rays[i].getTmin(), rays[i].getTmax(), infos[i]);
+        }
+    }
 
-    if (color.r < 0) color.r = 0;
-    if (color.g < 0) color.g = 0;
-    if (color.b < 0) color.b = 0;
+    // Llums de cada pixel: es trien amb la mateixa seqüència aleatòria del pixel que
+    // farien servir samplePixel() i el shading, de manera que la imatge és la mateixa
+    int maxSamples = context.shading->usesShadows() ? context.maxLightSamples() : 0;
+    vector<LightSample> samples((size_t)n * maxSamples);
+    vector<int>         numSamples(n, 0);
+    vector<ShadowRay>   shadowRays;
+    if (maxSamples > 0) {
+        Random &rng = Random::local();
+        for (int i = 0; i < n; i++) {
+            if (!hits[i]) continue;
+            rng.setSeed(context.seed, (uint64_t)(tile.y0 + i / tileWidth) * width + tile.x0 + i % tileWidth);
+            numSamples[i] = context.sampleLights(infos[i], rng, &samples[(size_t)i * maxSamples]);
+        }
+        // Els rajos d'ombra es tracen agrupats per llum (i per pixel dins de cada llum).
+        // Quan es fan servir totes les llums, la mostra s de cada pixel és la llum s i
+        // l'ordre per mostres ja les agrupa
+        shadowRays.reserve((size_t)n * maxSamples);
+        for (int s = 0; s < maxSamples; s++) {
+            for (int i = 0; i < n; i++)
+                if (s < numSamples[i]) shadowRays.push_back(ShadowRay{i, i * maxSamples + s});
+        }
+        if (context.sampledLights()) {
+            std::stable_sort(shadowRays.begin(), shadowRays.end(), [&](const ShadowRay &a, const ShadowRay &b) {
+                return samples[a.sample].light < samples[b.sample].light;
+            });
+        }
+        traceShadows(shadowRays, infos, samples);
+    }
+
+    for (int i = 0; i < n; i++) {
+        const LightSample *s = maxSamples > 0 ? &samples[(size_t)i * maxSamples] : nullptr;
+        setPixel(tile.x0 + i % tileWidth, tile.y0 + i / tileWidth, shade(rays[i], hits[i], infos[i], s, numSamples[i]));
+    }
+}
 
-    if (color.r > 255) color.r = 255;
-    if (color.g > 255) color.g = 255;
-    if (color.b > 255) color.b  = 255;
 
-    image->setPixelColor(x, y, QColor(color.r, color.g, color.b));
+void RayTracer::traceShadows(const vector<ShadowRay> &shadowRays, const vector<HitInfo> &infos,
+                             vector<LightSample> &samples) {
+    if (!context.rayPackets) {
+        for (const ShadowRay &r : shadowRays) {
+            LightSample &sample = samples[r.sample];
+            sample.weight *= ShadingStrategy::computeShadow(*context.scene, *sample.light, infos[r.pixel]);
+        }
+        return;
+    }
 
+    // Els rajos consecutius van cap a la mateixa llum des de pixels veïns i són
+    // coherents: s'agrupen en paquets amb els punts que miren cap a la llum
+    RayPacket packet;
+    int  sample[RayPacket::SIZE];
+    bool blocked[RayPacket::SIZE];
+    int  lanes = 0;
+    int  numRays = (int)shadowRays.size();
+    for (int r = 0; r <= numRays; r++) {
+        if (r < numRays) {
+            int k = shadowRays[r].sample;
+            Light &light = *samples[k].light;
+            const HitInfo &info = infos[shadowRays[r].pixel];
+            vec3 L = light.vectorL(info.p);
+            if (dot(L, info.normal) > 0.0f) {
+                packet.set(lanes, Ray(info.p, L, ShadingStrategy::SHADOW_EPSILON, light.distanceToLight(info.p)));
+                sample[lanes++] = k;
+            } else {
+                samples[k].weight = 0.0f;
+            }
+        }
+        if (lanes == RayPacket::SIZE || (r == numRays && lanes > 0)) {
+            packet.finish();
+            context.scene->occludedPacket(packet, ShadingStrategy::SHADOW_EPSILON, blocked);
+            for (int lane = 0; lane < lanes; lane++)
+                if (blocked[lane]) samples[sample[lane]].weight = 0.0f;
+            packet.reset();
+            lanes = 0;
+        }
+    }
+}
+
+
+void RayTracer::tracePackets(const Tile &tile, int width, int height,
+                             vector<Ray> &rays, vector<HitInfo> &infos, vector<char> &hits) {
+    const Camera *camera = context.camera;
+    Random &rng = Random::local();
+    int tileWidth = tile.x1 - tile.x0;
+
+    HitInfo packetInfos[RayPacket::SIZE];
+    bool    packetHits[RayPacket::SIZE];
+
+    for (int by = tile.y0; by < tile.y1; by += PACKET_HEIGHT) {
+        for (int bx = tile.x0; bx < tile.x1; bx += PACKET_WIDTH) {
+            // Els lanes que queden fora del tile es deixen inactius
+            RayPacket packet;
+            for (int lane = 0; lane < RayPacket::SIZE; lane++) {
+                int x = bx + lane % PACKET_WIDTH;
+                int y = by + lane / PACKET_WIDTH;
+                if (x >= tile.x1 || y >= tile.y1) continue;
+                rng.setSeed(context.seed, (uint64_t)y * width + x);
+                Ray r = camera->getRay(float(x) / float(width), float(height - y) / float(height));
+                packet.set(lane, r);
+            }
+            packet.finish();
+
+            // Tots els rajos de càmera tenen la mateixa tmin
+            context.scene->hitPacket(packet, packet.rays[0].getTmin(), packetInfos, packetHits);
+
+            for (int lane = 0; lane < RayPacket::SIZE; lane++) {
+                if (!(packet.activeMask & (1 << lane))) continue;
+                int i = (by + lane / PACKET_WIDTH - tile.y0) * tileWidth + (bx + lane % PACKET_WIDTH - tile.x0);
+                rays[i] = packet.rays[lane];
+                infos[i] = packetInfos[lane];
+                hits[i] = packetHits[lane];
+            }
+        }
+    }
+}
+
+
+void RayTracer::setPixel(int x, int y, vec3 color) {
+    framebuffer.set(x, y, color);
 }
 
 /* Mètode RayPixel
@@ -65,19 +361,27 @@ void RayTracer::setPixel(int x, int y, vec3 color) {
 // Funcio recursiva que calcula el color.
 vec3 RayTracer::RayPixel(Ray &ray) {
 
-    vec3 color = vec3(0);
-    vec3 unit_direction;
     HitInfo info;
+    bool hit = context.scene->hit(ray, ray.getTmin(), ray.getTmax(), info);
+    return shade(ray, hit, info);
+}
+
+
+vec3 RayTracer::shade(Ray &ray, bool hit, HitInfo &info, const LightSample *samples, int numSamples) {
+
+    vec3 color = vec3(0);
 
     // If the ray hits an object
-    if (scene->hit(ray, 0.0, numeric_limits<float>::infinity(), info)) {
+    if (hit) {
         //color = info.mat_ptr->Kd;
-        shared_ptr<ShadingStrategy>shadingStrategy = setup->getShadingStrategy();
-        color = shadingStrategy->shading(scene, info, setup->getCamera()->getLookFrom());
+        if (samples != nullptr)
+            color = context.shading->shadingWithVisibility(context, info, samples, numSamples);
+        else
+            color = context.shading->shading(context, info);
     // If the ray does not hit an object
     } else {
         // Set color to background
-        if (setup->getBackground()){
+        if (context.background){
             vec3 ray2 = normalize(ray.getDirection());
             float t = 0.5f*(ray2.y + 1);
             color = (1 - t)*vec3(1, 1, 1) + t*vec3(0.5, 0.7, 1);
@@ -90,8 +394,11 @@ vec3 RayTracer::RayPixel(Ray &ray) {
 
 
 void RayTracer::init() {
+    scene->buildBVH();
+
     auto s = setup->getShadingStrategy();
     auto s_out = ShadingFactory::getInstance().switchShading(s, setup->getShadows());
     if (s_out!=nullptr) setup->setShadingStrategy(s_out);
+    context.resolve(*setup, *scene);
 }
 
@@ -3,9 +3,18 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <mutex>
+#include <atomic>
+#include <chrono>
 
 #include "Controller.hh"
 #include "SetUp.hh"
+#include "TileScheduler.hh"
+#include "RenderStats.hh"
+#include "AccumulationBuffer.hh"
+#include "FrameBuffer.hh"
+#include "RenderContext.hh"
+#include "Model/Modelling/Materials/ColorMapStatic.hh"
 
 #include "glm/glm.hpp"
 
@@ -25,16 +34,71 @@ class RayTracer {
         shared_ptr<Scene>  scene;
 
         RayTracer(QImage *i);
+
+        // Guarda el color (lineal, 1 = blanc) del pixel al framebuffer. La imatge
+        // s'omple a partir del framebuffer al final de run()
         void setPixel(int x, int y, vec3 color);
 
+        const FrameBuffer &getFrameBuffer() const { return framebuffer; }
+
         void run();
 
+        const RenderStats &getStats() const { return stats; }
+
+        // Render progressiu: calcula una passada sobre accum. La passada 0 és una
+        // previsualització a baixa resolució (un raig per bloc de PREVIEW_BLOCK x
+        // PREVIEW_BLOCK pixels); cadascuna de les següents afegeix una mostra amb
+        // jitter a cada pixel. Retorna fals si s'ha cancel·lat a mitja passada.
+        bool runPass(int pass, AccumulationBuffer &accum, const atomic<bool> &cancel);
+
+        static const int PREVIEW_BLOCK = 8;
+
 private:
-        // Funció d'inicialització del raytracing.
+        RenderStats stats;
+        FrameBuffer framebuffer;
+
+        // Escena, càmera, llums i shading del frame en curs, resolts a init()
+        RenderContext context;
+
+        // Funció d'inicialització del raytracing. Omple el context del frame
         void init();
 
+        // Color del pixel (x, y) fent la mitjana de les mostres del pixel. samplesUsed
+        // retorna quantes mostres s'han calculat (menys de les del setup si és adaptatiu)
+        vec3 samplePixel(int x, int y, int width, int height, int &samplesUsed);
+
+        // Calcula els pixels del tile amb una mostra per pixel. Dona els mateixos
+        // colors que samplePixel(), però traça els rajos per lots: els primaris en
+        // paquets (si el setup ho permet) i els d'ombra agrupats per llum
+        void renderTile(const Tile &tile, int width, int height);
+
+        // Interseccio dels rajos primaris del tile en paquets de PACKET_WIDTH x
+        // PACKET_HEIGHT pixels. Deixa el raig, la interseccio i si n'hi ha de cada pixel
+        // a rays, infos i hits, per files del tile
+        void tracePackets(const Tile &tile, int width, int height,
+                          vector<Ray> &rays, vector<HitInfo> &infos, vector<char> &hits);
+
+        // Raig d'ombra del tile: des del punt del pixel cap a la llum de samples[sample]
+        struct ShadowRay {
+            int pixel;
+            int sample;
+        };
+
+        // Traça els rajos d'ombra (en paquets si rayPackets està activat) i posa a zero
+        // el pes de les mostres de llum que queden a l'ombra
+        void traceShadows(const vector<ShadowRay> &shadowRays, const vector<HitInfo> &infos,
+                          vector<LightSample> &samples);
+
+        static const int PACKET_HEIGHT = 2;
+        static const int PACKET_WIDTH = RayPacket::SIZE / PACKET_HEIGHT;
+
         // Funcio recursiva que calcula el color. Inicialment
         // es crida a cada pixel de forma no recursiva.
         vec3 RayPixel (Ray &ray);
+
+        // Color del raig un cop calculada la interseccio amb l'escena: el shading si
+        // n'hi ha (hit) i el fons si no. samples, si no és nul, té les llums del punt
+        // amb la visibilitat ja calculada
+        vec3 shade(Ray &ray, bool hit, HitInfo &info, const LightSample *samples = nullptr, int numSamples = 0);
 };
 
@@ -0,0 +1,22 @@
+#include "RenderContext.hh"
+#include "SetUp.hh"
+
+void RenderContext::resolve(SetUp &setup, Scene &s) {
+    scene = &s;
+    camera = setup.getCamera().get();
+    shading = setup.getShadingStrategy().get();
+    lookFrom = camera->getLookFrom();
+
+    vector<shared_ptr<Light>> setupLights = setup.getLights();
+    lights.clear();
+    for (const shared_ptr<Light> &l : setupLights)
+        lights.push_back(l.get());
+    globalLight = setup.getGlobalLight();
+    lightSamples = setup.getLightSamples();
+    if (sampledLights()) lightTree.build(setupLights);
+    else lightTree.clear();
+
+    background = setup.getBackground();
+    seed = setup.getSeed();
+    rayPackets = setup.getRayPackets();
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include "glm/glm.hpp"
+#include "Camera.hh"
+#include "Model/Modelling/Scene.hh"
+#include "Model/Modelling/Lights/LightTree.hh"
+
+using namespace std;
+using namespace glm;
+
+class SetUp;
+class ShadingStrategy;
+
+// Tot el que necessita el camí d'un raig, resolt un cop per frame a partir del setup
+// i de l'escena. Només té punters i valors: es passa per referència constant i els
+// threads del render el llegeixen sense tocar cap comptador de shared_ptr.
+// Els objectes apuntats els mantenen vius el RayTracer (setup i scene) durant el frame.
+struct RenderContext
+{
+    const Scene      *scene = nullptr;
+    const Camera     *camera = nullptr;
+    ShadingStrategy  *shading = nullptr;
+
+    vec3  lookFrom = vec3(0.0f);
+    vector<Light*> lights;
+    vec3  globalLight = vec3(0.0f);
+    // Llums escollides per punt amb el lightTree (0: totes)
+    int   lightSamples = 0;
+    LightTree lightTree;
+
+    bool  background = true;
+    unsigned int seed = 0;
+    bool  rayPackets = true;
+
+    // Omple el context amb l'estat actual del setup i l'escena
+    void resolve(SetUp &setup, Scene &scene);
+
+    // Llums que il·luminen el punt de info, amb el seu pes. Amb lightSamples > 0 i
+    // més llums puntuals que mostres, se n'escullen lightSamples amb el lightTree; si
+    // no, hi són totes amb pes 1. Retorna les mostres escrites a out
+    int sampleLights(const HitInfo &info, Random &rng, LightSample out[]) const {
+        if (sampledLights())
+            return lightTree.sample(info.p, info.normal, rng, lightSamples, out);
+        for (unsigned int i = 0; i < lights.size(); i++)
+            out[i] = LightSample{lights[i], 1.0f};
+        return (int)lights.size();
+    }
+
+    // Cert si sampleLights() escull les llums a l'atzar en lloc de donar-les totes
+    bool sampledLights() const {
+        return lightSamples > 0 && (int)lights.size() > lightSamples;
+    }
+
+    // Mida que ha de tenir el vector out de sampleLights()
+    int maxLightSamples() const {
+        return sampledLights() ? lightTree.maxSamples(lightSamples) : (int)lights.size();
+    }
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QTextStream>
+
+// Estadístiques de l'últim render: temps i nombre de rajos traçats. Els rajos
+// es compten a Scene::hit, de manera que inclouen els primaris i tots els que
+// llencin els shadings (ombres, reflexions...)
+class RenderStats
+{
+public:
+    int                width = 0;
+    int                height = 0;
+    int                numThreads = 0;
+    double             seconds = 0.0;
+    unsigned long long primaryRays = 0;
+    unsigned long long totalRays = 0;
+
+    double raysPerSecond() const { return seconds > 0.0 ? totalRays / seconds : 0.0; }
+
+    void print() const {
+        QTextStream(stdout) << "Render " << width << "x" << height << " with " << numThreads
+                            << " threads: " << seconds << " s, " << primaryRays << " primary rays ("
+                            << (width*height > 0 ? double(primaryRays) / (width*height) : 0.0) << " per pixel), "
+                            << totalRays << " rays (" << raysPerSecond() / 1.0e6 << " Mrays/s)\n";
+    }
+};
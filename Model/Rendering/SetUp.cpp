@@ -6,6 +6,14 @@ SetUp::SetUp()
   shade = make_shared<ShadingStrategy>();
   MAXDEPTH = 1;
   numSamples = 1;
+  numThreads = 0;
+  seed = 0;
+  adaptiveThreshold = 0.0f;
+  adaptiveMinSamples = 4;
+  samplesHeatmap = false;
+  gamma = 1.0f;
+  rayPackets = true;
+  lightSamples = 0;
   background = true;
   downBackground = vec3(1.0, 1.0, 1.0);
   topBackground = vec3(0.5, 0.7, 1.0);
@@ -102,6 +110,30 @@ void SetUp::read(const QJsonObject &json)
     if (json.contains("numSamples") && json["numSamples"].isDouble())
         numSamples = json["numSamples"].toInt();
 
+    if (json.contains("numThreads") && json["numThreads"].isDouble())
+        numThreads = json["numThreads"].toInt();
+
+    if (json.contains("seed") && json["seed"].isDouble())
+        seed = json["seed"].toInt();
+
+    if (json.contains("adaptiveThreshold") && json["adaptiveThreshold"].isDouble())
+        adaptiveThreshold = json["adaptiveThreshold"].toDouble();
+
+    if (json.contains("adaptiveMinSamples") && json["adaptiveMinSamples"].isDouble())
+        adaptiveMinSamples = json["adaptiveMinSamples"].toInt();
+
+    if (json.contains("samplesHeatmap") && json["samplesHeatmap"].isBool())
+        samplesHeatmap = json["samplesHeatmap"].toBool();
+
+    if (json.contains("gamma") && json["gamma"].isDouble())
+        gamma = json["gamma"].toDouble();
+
+    if (json.contains("rayPackets") && json["rayPackets"].isBool())
+        rayPackets = json["rayPackets"].toBool();
+
+    if (json.contains("lightSamples") && json["lightSamples"].isDouble())
+        lightSamples = json["lightSamples"].toInt();
+
     if (json.contains("shading") && json["shading"].isString()) {
         QString tipus = json["shading"].toString().toUpper();
         ShadingFactory::SHADING_TYPES t = ShadingFactory::getInstance().getShadingType(tipus);
@@ -138,6 +170,14 @@ void SetUp::write(QJsonObject &json) const
     json["background"] = background;
     json["MAXDEPTH"] = MAXDEPTH;
     json["numSamples"] = numSamples;
+    json["numThreads"] = numThreads;
+    json["seed"] = (int)seed;
+    json["adaptiveThreshold"] = adaptiveThreshold;
+    json["adaptiveMinSamples"] = adaptiveMinSamples;
+    json["samplesHeatmap"] = samplesHeatmap;
+    json["gamma"] = gamma;
+    json["rayPackets"] = rayPackets;
+    json["lightSamples"] = lightSamples;
 
     auto  value = ShadingFactory::getInstance().getIndexType (shade);
     QString className = ShadingFactory::getInstance().getNameType(value);
@@ -166,6 +206,14 @@ void SetUp::print(int indentation) const
     QTextStream(stdout) << indent << "background:\t" << background << "\n";
     QTextStream(stdout) << indent << "MAXDEPTH:\t" << MAXDEPTH << "\n";
     QTextStream(stdout) << indent << "numSamples:\t" << numSamples << "\n";
+    QTextStream(stdout) << indent << "numThreads:\t" << numThreads << "\n";
+    QTextStream(stdout) << indent << "seed:\t" << seed << "\n";
+    QTextStream(stdout) << indent << "adaptiveThreshold:\t" << adaptiveThreshold << "\n";
+    QTextStream(stdout) << indent << "adaptiveMinSamples:\t" << adaptiveMinSamples << "\n";
+    QTextStream(stdout) << indent << "samplesHeatmap:\t" << samplesHeatmap << "\n";
+    QTextStream(stdout) << indent << "gamma:\t" << gamma << "\n";
+    QTextStream(stdout) << indent << "rayPackets:\t" << rayPackets << "\n";
+    QTextStream(stdout) << indent << "lightSamples:\t" << lightSamples << "\n";
     QTextStream(stdout) << indent << "globalLight:\t" << globalLight[0] << ", "<< globalLight[1] << ", "<< globalLight[2] << "\n";
     QTextStream(stdout) << indent << "colorTopBackground:\t" << topBackground[0] << ", "<< topBackground[1] << ", "<< topBackground[2] << "\n";
     QTextStream(stdout) << indent << "colorDownBackground:\t" << downBackground[0] << ", "<< downBackground[1] << ", "<< downBackground[2] << "\n";
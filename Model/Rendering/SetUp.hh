@@ -27,6 +27,14 @@ public:
     vec3                            getDownBackground();
     int                             getMAXDEPTH();
     int                             getSamples();
+    int                             getNumThreads() {return numThreads;}
+    unsigned int                    getSeed() {return seed;}
+    float                           getAdaptiveThreshold() {return adaptiveThreshold;}
+    int                             getAdaptiveMinSamples() {return adaptiveMinSamples;}
+    bool                            getSamplesHeatmap() {return samplesHeatmap;}
+    float                           getGamma() {return gamma;}
+    bool                            getRayPackets() {return rayPackets;}
+    int                             getLightSamples() {return lightSamples;}
     bool                            getReflections() {return reflections;}
     bool                            getRefractions() {return refractions;}
     bool                            getShadows() {return shadows;}
@@ -42,6 +50,14 @@ public:
     void setTopBackground(vec3 color);
     void setDownBackground(vec3 color);
     void setSamples(int s);
+    void setNumThreads(int n) {numThreads = n;}
+    void setSeed(unsigned int s) {seed = s;}
+    void setAdaptiveThreshold(float t) {adaptiveThreshold = t;}
+    void setAdaptiveMinSamples(int n) {adaptiveMinSamples = n;}
+    void setSamplesHeatmap(bool b) {samplesHeatmap = b;}
+    void setGamma(float g) {gamma = g;}
+    void setRayPackets(bool b) {rayPackets = b;}
+    void setLightSamples(int n) {lightSamples = n;}
     void setReflections(bool b);
     void setRefractions(bool b);
     void setShadows(bool b);
@@ -84,6 +100,31 @@ private:
     // number of samples per pixels
     int   numSamples;
 
+    // Mostreig adaptatiu: es deixen de llençar rajos a un pixel quan l'error
+    // estàndard de la seva lluminància baixa de adaptiveThreshold (0: desactivat),
+    // sempre que ja en tingui com a mínim adaptiveMinSamples
+    float adaptiveThreshold;
+    int   adaptiveMinSamples;
+    // Si és cert, la imatge mostra les mostres calculades a cada pixel en lloc del color
+    bool  samplesHeatmap;
+
+    // correcció gamma en passar la imatge a 8 bits (1: sense correcció)
+    float gamma;
+
+    // Si és cert, els rajos primaris amb una mostra per pixel es tracen en paquets
+    // de pixels veïns que recorren el BVH junts
+    bool  rayPackets;
+
+    // Llums escollides a l'atzar per a cada punt amb ombres (0: totes les llums).
+    // Amb moltes llums puntuals, el cost de les ombres deixa de créixer amb el nombre de llums
+    int   lightSamples;
+
+    // nombre de threads del render (0: tots els cores disponibles)
+    int   numThreads;
+
+    // llavor dels nombres aleatoris: el mateix valor dona la mateixa imatge
+    unsigned int seed;
+
     // flags per activar funcionalitats del RayColor
     // FASE 3: cal usar-los allà
      bool reflections;
@@ -1,17 +1,42 @@
 #pragma once
 
 #include "Model/Modelling/Scene.hh"
+#include "Model/Modelling/Lights/Light.hh"
+#include "Model/Modelling/Lights/LightTree.hh"
+#include "RenderContext.hh"
 
 
 class ShadingStrategy {
  public:
-    // TODO: Fase 2: Canviar el mètode per passar les llums per calcular el shading
-    virtual vec3 shading(shared_ptr<Scene> scene, HitInfo& info, vec3 lookFrom) {
+    // Color del punt de info. El context té l'escena, la càmera i les llums del frame
+    virtual vec3 shading(const RenderContext &context, const HitInfo &info) const {
         return vec3(0.0, 0.0, 0.0);
     };
 
+    // Shading amb les llums ja escollides i la seva visibilitat calculada: cada mostra
+    // té una llum i el pes de la seva contribució, que és zero si el punt hi és a
+    // l'ombra. El RayTracer la fa servir quan traça els rajos d'ombra per lots. Per
+    // defecte no té en compte les llums
+    virtual vec3 shadingWithVisibility(const RenderContext &context, const HitInfo &info,
+                                       const LightSample *samples, int numSamples) const {
+        return shading(context, info);
+    }
+
+    // Cert si el shading fa servir la visibilitat de les llums (ombres)
+    virtual bool usesShadows() const { return false; }
+
     // FASE 2: Calcula si el punt "point" és a l'ombra segons si el flag està activat o no
-    // float computeShadow(shared_ptr<Light> light, vec3 point);
+    // Retorna 1 si el punt de info veu la llum i 0 si és a l'ombra. Els punts d'una
+    // cara que no mira cap a la llum són a l'ombra sense traçar cap raig
+    static float computeShadow(const Scene &scene, Light &light, const HitInfo &info) {
+        vec3 L = light.vectorL(info.p);
+        if (dot(L, info.normal) <= 0.0f) return 0.0f;
+        Ray shadowRay(info.p, L, SHADOW_EPSILON);
+        return scene.occluded(shadowRay, light.distanceToLight(info.p)) ? 0.0f : 1.0f;
+    }
+
+    // Distància mínima dels rajos d'ombra, per no intersecar la mateixa superfície
+    static constexpr float SHADOW_EPSILON = 1e-3f;
 
     virtual ~ShadingStrategy() {};
 };
@@ -0,0 +1,70 @@
+#include "TileScheduler.hh"
+
+#include <thread>
+
+TileScheduler::TileScheduler(int width, int height, int numThreads, int tileSize)
+{
+    this->numThreads = resolveNumThreads(numThreads);
+
+    // Els tiles es recorren de dalt a baix, com feia el recorregut per scanlines
+    for (int y1 = height; y1 > 0; y1 -= tileSize) {
+        int y0 = y1 - tileSize > 0 ? y1 - tileSize : 0;
+        for (int x0 = 0; x0 < width; x0 += tileSize) {
+            int x1 = x0 + tileSize < width ? x0 + tileSize : width;
+            tiles.push_back({x0, y0, x1, y1});
+        }
+    }
+    if ((int)tiles.size() < this->numThreads)
+        this->numThreads = tiles.size() > 0 ? (int)tiles.size() : 1;
+}
+
+int TileScheduler::resolveNumThreads(int requested) {
+    if (requested > 0) return requested;
+    int n = (int)thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+bool TileScheduler::nextTile(vector<WorkQueue> &queues, int threadId, int &tileIdx) const {
+    // Primer la cua pròpia i, si és buida, es roba de la resta de cues
+    for (int i = 0; i < numThreads; i++) {
+        WorkQueue &q = queues[(threadId + i) % numThreads];
+        if (q.next.load(memory_order_relaxed) >= q.end) continue;
+        int idx = q.next.fetch_add(1, memory_order_relaxed);
+        if (idx < q.end) {
+            tileIdx = idx;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TileScheduler::run(const function<void(const Tile &, int)> &renderTile,
+                        const function<void(int)> &onTileDone) {
+    int nTiles = (int)tiles.size();
+    if (nTiles == 0) return;
+
+    // Repartiment inicial: blocs contigus de tiles per thread
+    vector<WorkQueue> queues(numThreads);
+    for (int t = 0; t < numThreads; t++) {
+        queues[t].next.store(nTiles * t / numThreads);
+        queues[t].end = nTiles * (t + 1) / numThreads;
+    }
+
+    atomic<int> remaining(nTiles);
+    auto worker = [&](int threadId) {
+        int idx;
+        while (nextTile(queues, threadId, idx)) {
+            renderTile(tiles[idx], threadId);
+            int left = remaining.fetch_sub(1) - 1;
+            if (onTileDone) onTileDone(left);
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 1; t < numThreads; t++)
+        pool.push_back(thread(worker, t));
+    // El thread que crida també treballa
+    worker(0);
+    for (unsigned int t = 0; t < pool.size(); t++)
+        pool[t].join();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+using namespace std;
+
+// Tile - rectangle de pixels [x0, x1) x [y0, y1) del viewport
+struct Tile
+{
+    int x0, y0;
+    int x1, y1;
+};
+
+// Classe que divideix el viewport en tiles de mida fixa i els reparteix entre
+// un pool de threads. Cada thread té la seva pròpia cua de tiles i, quan la buida,
+// en roba dels altres threads (work stealing).
+class TileScheduler
+{
+public:
+    static const int TILE_SIZE = 32;
+
+    // numThreads <= 0 vol dir utilitzar tots els cores disponibles
+    TileScheduler(int width, int height, int numThreads, int tileSize = TILE_SIZE);
+
+    // Crida renderTile(tile, threadId) per a cada tile del viewport. Retorna quan
+    // tots els tiles s'han calculat. onTileDone es crida (si no és null) després de
+    // cada tile amb el nombre de tiles que falten.
+    void run(const function<void(const Tile &, int)> &renderTile,
+             const function<void(int)> &onTileDone = nullptr);
+
+    int getNumThreads() const { return numThreads; }
+    int getNumTiles() const { return (int)tiles.size(); }
+
+    static int resolveNumThreads(int requested);
+
+private:
+    // Cua d'un thread: tiles [next, end) pendents. La resta de threads hi poden
+    // robar fent el mateix fetch_add sobre next. El padding evita el false sharing
+    // entre les cues de threads diferents.
+    struct WorkQueue
+    {
+        atomic<int> next;
+        int         end;
+        char        padding[64 - sizeof(atomic<int>) - sizeof(int)];
+    };
+
+    int          numThreads;
+    vector<Tile> tiles;
+
+    bool nextTile(vector<WorkQueue> &queues, int threadId, int &tileIdx) const;
+};
@@ -12,6 +12,9 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++11
 QMAKE_CXXFLAGS += -O1 -Wno-expansion-to-defined -Wno-unused-parameter
+# Amb "qmake CONFIG+=avx" els camins SIMD (Simd.hh) fan servir AVX, amb 8 lanes
+# en lloc dels 4 d'SSE. L'executable només funciona en processadors amb AVX
+avx: QMAKE_CXXFLAGS += -mavx
 
 
 # You can make your code fail to compile if it uses deprecated APIs.
@@ -23,14 +26,20 @@ RESOURCES = resources.qrc
 SOURCES += \
     Controller.cpp \
     DataInOut/AttributeMapping.cpp \
+    DataInOut/MeshCache.cpp \
+    DataInOut/ObjReader.cpp \
+    DataInOut/DataFileReader.cpp \
     DataInOut/Output.cpp \
     DataInOut/Serializable.cpp \
     DataInOut/VisualMapping.cpp \
     Main.cpp \
     Model/Builder.cpp \
     Model/Modelling/Animation.cpp \
+    Model/Modelling/BVH.cpp \
+    Model/Modelling/PrimitiveStore.cpp \
     Model/Modelling/Lights/Light.cpp \
     Model/Modelling/Lights/LightFactory.cpp \
+    Model/Modelling/Lights/LightTree.cpp \
     Model/Modelling/Lights/PointLight.cpp \
     Model/Modelling/Materials/ColorMapStatic.cpp \
     Model/Modelling/Materials/Lambertian.cpp \
@@ -45,6 +54,7 @@ SOURCES += \
     Model/Modelling/Objects/ObjectFactory.cpp \
     Model/Modelling/Objects/Plane.cpp \
     Model/Modelling/Objects/Sphere.cpp \
+    Model/Modelling/Objects/SphereSet.cpp \
     Model/Modelling/Objects/Triangle.cpp \
     Model/Modelling/Scene.cpp \
     Model/Modelling/SceneFactory.cpp \
@@ -53,13 +63,18 @@ SOURCES += \
     Model/Modelling/TG/TG.cpp \
     Model/Modelling/TG/TranslateTG.cpp \
     Model/Rendering/Camera.cpp \
+    Model/Rendering/AccumulationBuffer.cpp \
     Model/Rendering/ColorShading.cpp \
     Model/Rendering/ColorShadow.cpp \
     Model/Rendering/DepthShading.cpp \
+    Model/Rendering/FrameBuffer.cpp \
     Model/Rendering/NormalShading.cpp \
     Model/Rendering/RayTracer.cc \
+    Model/Rendering/RenderContext.cpp \
+    Model/Rendering/ProgressiveRenderer.cpp \
     Model/Rendering/SetUp.cpp \
     Model/Rendering/ShadingFactory.cpp \
+    Model/Rendering/TileScheduler.cpp \
     View/CameraMenu.cpp \
     View/Label.cpp \
     View/MainWindow.cpp
@@ -67,20 +82,32 @@ SOURCES += \
 HEADERS += \
     Controller.hh \
     DataInOut/AttributeMapping.hh \
+    DataInOut/MeshCache.hh \
+    DataInOut/ObjReader.hh \
+    DataInOut/NumberParsing.hh \
+    DataInOut/DataFileReader.hh \
     DataInOut/Output.hh \
     DataInOut/Serializable.hh \
     DataInOut/VisualMapping.hh \
     Model/Builder.hh \
     Model/Modelling/Animation.hh \
+    Model/Modelling/AABB.hh \
+    Model/Modelling/BVH.hh \
+    Model/Modelling/PrimitiveStore.hh \
+    Model/Modelling/RayPacket.hh \
+    Model/Modelling/Simd.hh \
     Model/Modelling/Hitable.hh \
+    Model/Modelling/Random.hh \
     Model/Modelling/Lights/Light.hh \
     Model/Modelling/Lights/LightFactory.hh \
+    Model/Modelling/Lights/LightTree.hh \
     Model/Modelling/Lights/PointLight.hh \
     Model/Modelling/Materials/ColorMap.hh \
     Model/Modelling/Materials/ColorMapStatic.hh \
     Model/Modelling/Materials/Lambertian.hh \
     Model/Modelling/Materials/Material.hh \
     Model/Modelling/Materials/MaterialFactory.hh \
+    Model/Modelling/Materials/MaterialTable.hh \
     Model/Modelling/Materials/Texture.hh \
     Model/Modelling/Objects/Box.hh \
     Model/Modelling/Objects/Cylinder.hh \
@@ -90,6 +117,7 @@ HEADERS += \
     Model/Modelling/Objects/ObjectFactory.hh \
     Model/Modelling/Objects/Plane.hh \
     Model/Modelling/Objects/Sphere.hh \
+    Model/Modelling/Objects/SphereSet.hh \
     Model/Modelling/Objects/Triangle.hh \
     Model/Modelling/Ray.hh \
     Model/Modelling/Scene.hh \
@@ -99,14 +127,20 @@ HEADERS += \
     Model/Modelling/TG/TG.hh \
     Model/Modelling/TG/TranslateTG.hh \
     Model/Rendering/Camera.hh \
+    Model/Rendering/AccumulationBuffer.hh \
     Model/Rendering/ColorShading.hh \
     Model/Rendering/ColorShadow.hh \
     Model/Rendering/DepthShading.hh \
+    Model/Rendering/FrameBuffer.hh \
     Model/Rendering/NormalShading.hh \
     Model/Rendering/RayTracer.hh \
+    Model/Rendering/RenderContext.hh \
+    Model/Rendering/ProgressiveRenderer.hh \
+    Model/Rendering/RenderStats.hh \
     Model/Rendering/SetUp.hh \
     Model/Rendering/ShadingFactory.hh \
     Model/Rendering/ShadingStrategy.hh \
+    Model/Rendering/TileScheduler.hh \
     View/CameraMenu.hh \
     View/Label.hh \
     View/MainWindow.hh \
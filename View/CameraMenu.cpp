@@ -61,4 +61,5 @@ void CameraMenu::modify() {
 
     Controller::getInstance()->getSetUp()->setCamera(camera);
 
+    emit cameraChanged();
 }
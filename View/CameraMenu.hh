@@ -15,6 +15,9 @@ public slots:
     void cameraMenuShow();
     void close();
     void modify();
+signals:
+    // S'emet quan s'accepten canvis a la càmera
+    void cameraChanged();
 };
 
 
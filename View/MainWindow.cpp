@@ -55,12 +55,17 @@ MainWindow::MainWindow(QWidget *parent) :
 
 
     QObject::connect(builder, SIGNAL(settingsChanged()), this, SLOT(refreshWindow()));
+
+    // Render progressiu
+    QObject::connect(&refreshTimer, SIGNAL(timeout()), this, SLOT(refreshProgressive()));
+    QObject::connect(cameraMenu, SIGNAL(cameraChanged()), this, SLOT(restartProgressive()));
 }
 
 
 
 MainWindow::~MainWindow()
 {
+    progressive.stop();
     delete builder;
     delete outputFile;
     delete cameraMenu;
@@ -159,6 +164,14 @@ QImage MainWindow::getImage() { return image;}
 
 void MainWindow::trace() {
 
+    if (ui->valProgressive->isChecked()) {
+        startProgressive();
+        return;
+    }
+    progressive.stop();
+    refreshTimer.stop();
+    progressiveStarted = false;
+
     int width, height;
 
     // Camera parameters from the Controller
@@ -174,7 +187,36 @@ void MainWindow::trace() {
     outputFile->setImage(image);
 }
 
+void MainWindow::startProgressive() {
+    auto camera = Controller::getInstance()->getSetUp()->getCamera();
+    image = QImage(camera->viewportX, camera->viewportY, QImage::Format_RGB888);
+
+    progressive.start();
+    progressiveStarted = true;
+    refreshTimer.start(REFRESH_MS);
+}
+
+void MainWindow::refreshProgressive() {
+    // Es consulta abans de copiar la imatge perquè l'última passada es mostri sencera
+    bool running = progressive.isRunning();
+    if (progressive.resolve(image)) {
+        screen.setPixmap(QPixmap::fromImage(image));
+        outputFile->setImage(image);
+    }
+    if (!running) refreshTimer.stop();
+}
+
+void MainWindow::restartProgressive() {
+    // Un canvi de càmera torna a començar l'acumulació de mostres
+    if (progressiveStarted && ui->valProgressive->isChecked())
+        startProgressive();
+}
+
 void MainWindow::runAnimation() {
+    progressive.stop();
+    refreshTimer.stop();
+    progressiveStarted = false;
+
 
     int width, height;
     vector<QImage> frames;
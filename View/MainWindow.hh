@@ -6,6 +6,7 @@
 #include <QProgressDialog>
 #include <QString>
 #include <QThread>
+#include <QTimer>
 
 #include "ui_main.h"
 #include "ui_about.h"
@@ -14,6 +15,7 @@
 #include "Model/Builder.hh"
 #include "DataInOut/Output.hh"
 #include "Model/Rendering/RayTracer.hh"
+#include "Model/Rendering/ProgressiveRenderer.hh"
 
 #include "Controller.hh"
 
@@ -49,6 +51,14 @@ private:
     Builder    *builder;
     CameraMenu *cameraMenu;
 
+    // Render progressiu: la imatge es refresca cada REFRESH_MS ms mentre es calcula
+    static const int    REFRESH_MS = 100;
+    ProgressiveRenderer progressive;
+    QTimer              refreshTimer;
+    bool                progressiveStarted = false;
+
+    void startProgressive();
+
 private slots:
     void on_valWidth_valueChanged(int arg1);
     void on_valHeight_valueChanged(int arg1);
@@ -61,6 +71,8 @@ private slots:
     void refreshWindow();
     void aboutMenu();
     void trace();
+    void refreshProgressive();
+    void restartProgressive();
     void runAnimation();
     void setColorTop();
     void setColorBottom();
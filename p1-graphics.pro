@@ -16,6 +16,10 @@ INCLUDEPATH += .
 # Input
 HEADERS += Controller.hh \
            DataInOut/AttributeMapping.hh \
+           DataInOut/MeshCache.hh \
+           DataInOut/ObjReader.hh \
+           DataInOut/NumberParsing.hh \
+           DataInOut/DataFileReader.hh \
            DataInOut/Output.hh \
            DataInOut/Serializable.hh \
            DataInOut/VisualMapping.hh \
@@ -145,30 +149,44 @@ HEADERS += Controller.hh \
            glm/gtx/wrap.hpp \
            glm/virtrev/xstream.hpp \
            Model/Modelling/Animation.hh \
+           Model/Modelling/AABB.hh \
+           Model/Modelling/BVH.hh \
+           Model/Modelling/PrimitiveStore.hh \
+           Model/Modelling/RayPacket.hh \
+           Model/Modelling/Simd.hh \
            Model/Modelling/Hitable.hh \
+           Model/Modelling/Random.hh \
            Model/Modelling/Ray.hh \
            Model/Modelling/Scene.hh \
            Model/Modelling/SceneFactory.hh \
            Model/Modelling/SceneFactoryData.hh \
            Model/Modelling/SceneFactoryVirtual.hh \
            Model/Rendering/Camera.hh \
+           Model/Rendering/AccumulationBuffer.hh \
            Model/Rendering/ColorShading.hh \
            Model/Rendering/ColorShadow.hh \
            Model/Rendering/DepthShading.hh \
+           Model/Rendering/FrameBuffer.hh \
            Model/Rendering/NormalShading.h \
            Model/Rendering/NormalShading.hh \
            Model/Rendering/RayTracer.hh \
+           Model/Rendering/RenderContext.hh \
+           Model/Rendering/ProgressiveRenderer.hh \
+           Model/Rendering/RenderStats.hh \
            Model/Rendering/SetUp.hh \
            Model/Rendering/ShadingFactory.hh \
            Model/Rendering/ShadingStrategy.hh \
+           Model/Rendering/TileScheduler.hh \
            Model/Modelling/Lights/Light.hh \
            Model/Modelling/Lights/LightFactory.hh \
+           Model/Modelling/Lights/LightTree.hh \
            Model/Modelling/Lights/PointLight.hh \
            Model/Modelling/Materials/ColorMap.hh \
            Model/Modelling/Materials/ColorMapStatic.hh \
            Model/Modelling/Materials/Lambertian.hh \
            Model/Modelling/Materials/Material.hh \
            Model/Modelling/Materials/MaterialFactory.hh \
+           Model/Modelling/Materials/MaterialTable.hh \
            Model/Modelling/Materials/Texture.hh \
            Model/Modelling/Objects/Box.hh \
            Model/Modelling/Objects/Cylinder.hh \
@@ -178,6 +196,7 @@ HEADERS += Controller.hh \
            Model/Modelling/Objects/ObjectFactory.hh \
            Model/Modelling/Objects/Plane.hh \
            Model/Modelling/Objects/Sphere.hh \
+           Model/Modelling/Objects/SphereSet.hh \
            Model/Modelling/Objects/Triangle.hh \
            Model/Modelling/TG/TG.hh \
            Model/Modelling/TG/TranslateTG.hh
@@ -185,6 +204,9 @@ FORMS += about.ui camera.ui main.ui
 SOURCES += Controller.cpp \
            Main.cpp \
            DataInOut/AttributeMapping.cpp \
+           DataInOut/MeshCache.cpp \
+           DataInOut/ObjReader.cpp \
+           DataInOut/DataFileReader.cpp \
            DataInOut/Output.cpp \
            DataInOut/Serializable.cpp \
            DataInOut/VisualMapping.cpp \
@@ -193,20 +215,28 @@ SOURCES += Controller.cpp \
            View/Label.cpp \
            View/MainWindow.cpp \
            Model/Modelling/Animation.cpp \
+           Model/Modelling/BVH.cpp \
+           Model/Modelling/PrimitiveStore.cpp \
            Model/Modelling/Scene.cpp \
            Model/Modelling/SceneFactory.cpp \
            Model/Modelling/SceneFactoryData.cpp \
            Model/Modelling/SceneFactoryVirtual.cpp \
            Model/Rendering/Camera.cpp \
+           Model/Rendering/AccumulationBuffer.cpp \
            Model/Rendering/ColorShading.cpp \
            Model/Rendering/ColorShadow.cpp \
            Model/Rendering/DepthShading.cpp \
+           Model/Rendering/FrameBuffer.cpp \
            Model/Rendering/NormalShading.cpp \
            Model/Rendering/RayTracer.cc \
+           Model/Rendering/RenderContext.cpp \
+           Model/Rendering/ProgressiveRenderer.cpp \
            Model/Rendering/SetUp.cpp \
            Model/Rendering/ShadingFactory.cpp \
+           Model/Rendering/TileScheduler.cpp \
            Model/Modelling/Lights/Light.cpp \
            Model/Modelling/Lights/LightFactory.cpp \
+           Model/Modelling/Lights/LightTree.cpp \
            Model/Modelling/Lights/PointLight.cpp \
            Model/Modelling/Materials/ColorMapStatic.cpp \
            Model/Modelling/Materials/Lambertian.cpp \
@@ -221,7 +251,12 @@ SOURCES += Controller.cpp \
            Model/Modelling/Objects/ObjectFactory.cpp \
            Model/Modelling/Objects/Plane.cpp \
            Model/Modelling/Objects/Sphere.cpp \
+           Model/Modelling/Objects/SphereSet.cpp \
            Model/Modelling/Objects/Triangle.cpp \
            Model/Modelling/TG/TG.cpp \
            Model/Modelling/TG/TranslateTG.cpp
 RESOURCES += resources.qrc
+
+# Amb "qmake CONFIG+=avx" els camins SIMD (Simd.hh) fan servir AVX, amb 8 lanes
+# en lloc dels 4 d'SSE. L'executable només funciona en processadors amb AVX
+avx: QMAKE_CXXFLAGS += -mavx